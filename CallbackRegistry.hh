@@ -0,0 +1,200 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+use Titon\Route\Exception\MissingCallbackException;
+use Titon\Route\Mixin\AsyncConditionCallback;
+use Titon\Route\Mixin\ConditionCallback;
+
+/**
+ * The CallbackRegistry manages named dispatch callbacks and conditions. Closures can not be serialized,
+ * so a route can only be cached when each of its closures is registered, in which case the name is persisted
+ * and the closure is resolved from the registry when the route is loaded. Closures must be registered before
+ * routes are loaded from the cache, and are looked up by identity, so routes must be given the registered instance.
+ *
+ * Conditions can also be referenced by a static method, like `Foo::isAdmin`, which does not require registration.
+ *
+ * @package Titon\Route
+ */
+class CallbackRegistry {
+
+    /**
+     * Registered asynchronous conditions keyed by name.
+     *
+     * @var Map<string, \Titon\Route\Mixin\AsyncConditionCallback>
+     */
+    protected static Map<string, AsyncConditionCallback> $asyncConditions = Map {};
+
+    /**
+     * Registered dispatch callbacks keyed by name.
+     *
+     * @var Map<string, \Titon\Route\RouteCallback>
+     */
+    protected static Map<string, RouteCallback> $callbacks = Map {};
+
+    /**
+     * Registered conditions keyed by name.
+     *
+     * @var Map<string, \Titon\Route\Mixin\ConditionCallback>
+     */
+    protected static Map<string, ConditionCallback> $conditions = Map {};
+
+    /**
+     * Names of all registered closures keyed by closure identity.
+     *
+     * @var Map<string, string>
+     */
+    protected static Map<string, string> $names = Map {};
+
+    /**
+     * Register a dispatch callback by name and return it.
+     *
+     * @param string $name
+     * @param \Titon\Route\RouteCallback $callback
+     * @return \Titon\Route\RouteCallback
+     */
+    public static function add(string $name, RouteCallback $callback): RouteCallback {
+        static::$callbacks[$name] = $callback;
+        static::$names[static::identify($callback)] = $name;
+
+        return $callback;
+    }
+
+    /**
+     * Register an asynchronous condition by name and return it.
+     *
+     * @param string $name
+     * @param \Titon\Route\Mixin\AsyncConditionCallback $condition
+     * @return \Titon\Route\Mixin\AsyncConditionCallback
+     */
+    public static function addAsyncCondition(string $name, AsyncConditionCallback $condition): AsyncConditionCallback {
+        static::$asyncConditions[$name] = $condition;
+        static::$names[static::identify($condition)] = $name;
+
+        return $condition;
+    }
+
+    /**
+     * Register a condition by name and return it.
+     *
+     * @param string $name
+     * @param \Titon\Route\Mixin\ConditionCallback $condition
+     * @return \Titon\Route\Mixin\ConditionCallback
+     */
+    public static function addCondition(string $name, ConditionCallback $condition): ConditionCallback {
+        static::$conditions[$name] = $condition;
+        static::$names[static::identify($condition)] = $name;
+
+        return $condition;
+    }
+
+    /**
+     * Remove all registered callbacks and conditions.
+     */
+    public static function flush(): void {
+        static::$asyncConditions->clear();
+        static::$callbacks->clear();
+        static::$conditions->clear();
+        static::$names->clear();
+    }
+
+    /**
+     * Return a dispatch callback by name.
+     *
+     * @param string $name
+     * @return \Titon\Route\RouteCallback
+     * @throws \Titon\Route\Exception\MissingCallbackException
+     */
+    public static function get(string $name): RouteCallback {
+        if (static::$callbacks->contains($name)) {
+            return static::$callbacks[$name];
+        }
+
+        throw new MissingCallbackException(sprintf('Callback %s does not exist', $name));
+    }
+
+    /**
+     * Return an asynchronous condition by name. A static method reference is registered on first use.
+     *
+     * @param string $name
+     * @return \Titon\Route\Mixin\AsyncConditionCallback
+     * @throws \Titon\Route\Exception\MissingCallbackException
+     */
+    public static function getAsyncCondition(string $name): AsyncConditionCallback {
+        if (static::$asyncConditions->contains($name)) {
+            return static::$asyncConditions[$name];
+        }
+
+        if (static::isMethodReference($name)) {
+            return static::addAsyncCondition($name, $route ==> call_user_func($name, $route));
+        }
+
+        throw new MissingCallbackException(sprintf('Asynchronous condition %s does not exist', $name));
+    }
+
+    /**
+     * Return a condition by name. A static method reference is registered on first use.
+     *
+     * @param string $name
+     * @return \Titon\Route\Mixin\ConditionCallback
+     * @throws \Titon\Route\Exception\MissingCallbackException
+     */
+    public static function getCondition(string $name): ConditionCallback {
+        if (static::$conditions->contains($name)) {
+            return static::$conditions[$name];
+        }
+
+        if (static::isMethodReference($name)) {
+            return static::addCondition($name, $route ==> (bool) call_user_func($name, $route));
+        }
+
+        throw new MissingCallbackException(sprintf('Condition %s does not exist', $name));
+    }
+
+    /**
+     * Return the name a closure was registered with, or null if it has not been registered.
+     *
+     * @param mixed $callback
+     * @return string
+     */
+    public static function getName(mixed $callback): ?string {
+        return static::$names->get(static::identify($callback));
+    }
+
+    /**
+     * Return a unique identifier for a callable. Closures are identified by object, method references created with
+     * `inst_meth()` or `class_meth()` by their object or class and method, and functions created with `fun()` by name.
+     * Registered closures are held by the registry, so their identifiers can not be re-used by other closures.
+     *
+     * @param mixed $callback
+     * @return string
+     */
+    public static function identify(mixed $callback): string {
+        if (is_object($callback)) {
+            return spl_object_hash($callback);
+
+        } else if (is_array($callback) && count($callback) === 2) {
+            $context = $callback[0];
+
+            return (is_object($context) ? spl_object_hash($context) : (string) $context) . '::' . (string) $callback[1];
+        }
+
+        return (string) $callback;
+    }
+
+    /**
+     * Return true if the name is a callable static method reference, like `Foo::isAdmin`.
+     *
+     * @param string $name
+     * @return bool
+     */
+    protected static function isMethodReference(string $name): bool {
+        return (strpos($name, '::') !== false && is_callable($name));
+    }
+
+}
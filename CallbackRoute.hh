@@ -7,12 +7,12 @@
 
 namespace Titon\Route;
 
-use Titon\Route\Exception\NoMatchException;
 use ReflectionFunction;
 
 /**
  * The CallbackRoute works in a similar fashion to the default Route with the only difference being
- * that a callback is used for dispatching instead of an action.
+ * that a callback is used for dispatching instead of an action. The route can only be cached
+ * if the callback has been registered in the `CallbackRegistry`, as closures can not be serialized.
  *
  * @package Titon\Route
  */
@@ -40,14 +40,10 @@ class CallbackRoute extends Route {
     /**
      * {@inheritdoc}
      */
-    public function dispatch(): mixed {
-        if (!$this->isMatched()) {
-            throw new NoMatchException('Route cannot be dispatched unless it has been matched');
-        }
-
+    public function dispatch(MatchResult $result): mixed {
         $callback = new ReflectionFunction($this->getCallback());
 
-        return $callback->invokeArgs($this->getArguments($callback));
+        return $callback->invokeArgs($this->getArguments($callback, $result->getParams()));
     }
 
     /**
@@ -59,6 +55,25 @@ class CallbackRoute extends Route {
         return $this->callback;
     }
 
+    /**
+     * {@inheritdoc}
+     */
+    public function isCacheable(): bool {
+        return (CallbackRegistry::getName($this->getCallback()) !== null && parent::isCacheable());
+    }
+
+    /**
+     * Serialize the route along with the registered name of the callback.
+     *
+     * @return string
+     */
+    public function serialize(): string {
+        return serialize([
+            'callback' => (string) CallbackRegistry::getName($this->getCallback()),
+            'route' => parent::serialize()
+        ]);
+    }
+
     /**
      * Set the callback function.
      *
@@ -71,4 +86,17 @@ class CallbackRoute extends Route {
         return $this;
     }
 
+    /**
+     * Unserialize the route and resolve the callback from the registry.
+     *
+     * @param string $data
+     */
+    public function unserialize(/* HH_FIXME[4032]: no type hint */ $data): void {
+        $data = unserialize($data);
+
+        parent::unserialize($data['route']);
+
+        $this->setCallback(CallbackRegistry::get($data['callback']));
+    }
+
 }
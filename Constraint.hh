@@ -0,0 +1,146 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+use Titon\Route\Exception\MissingConstraintException;
+
+/**
+ * The Constraint registry manages named token constraints. Each constraint has a regex pattern,
+ * which is used when compiling a route, and a validator, which is used by segment based matchers
+ * to check a token without evaluating a regex. Both must accept the same values, and patterns must list
+ * uppercase letters explicitly, as case-sensitive routes are compiled without the `i` modifier.
+ * Neither may accept a slash, as a constrained token is always resolved as a single segment.
+ * The `{}`, `[]`, and `()` constraints are reserved for regular tokens of the same kind.
+ *
+ * @package Titon\Route
+ */
+class Constraint {
+
+    /**
+     * Registered constraints keyed by name.
+     *
+     * @var Map<string, \Titon\Route\ConstraintDefinition>
+     */
+    protected static Map<string, ConstraintDefinition> $constraints = Map {};
+
+    /**
+     * Have the built-in constraints been registered.
+     *
+     * @var bool
+     */
+    protected static bool $loaded = false;
+
+    /**
+     * Register a constraint, or overwrite an existing constraint, by name.
+     *
+     * @param string $name
+     * @param string $pattern
+     * @param \Titon\Route\ConstraintCallback $validator
+     */
+    public static function add(string $name, string $pattern, ConstraintCallback $validator): void {
+        static::loadDefaults();
+
+        static::$constraints[$name] = shape(
+            'pattern' => $pattern,
+            'validator' => $validator
+        );
+    }
+
+    /**
+     * Return all registered constraints.
+     *
+     * @return Map<string, \Titon\Route\ConstraintDefinition>
+     */
+    public static function all(): Map<string, ConstraintDefinition> {
+        static::loadDefaults();
+
+        return static::$constraints;
+    }
+
+    /**
+     * Return a constraint by name.
+     *
+     * @param string $name
+     * @return \Titon\Route\ConstraintDefinition
+     * @throws \Titon\Route\Exception\MissingConstraintException
+     */
+    public static function get(string $name): ConstraintDefinition {
+        if (static::has($name)) {
+            return static::$constraints[$name];
+        }
+
+        throw new MissingConstraintException(sprintf('Constraint %s does not exist', $name));
+    }
+
+    /**
+     * Return the regex pattern for a constraint.
+     *
+     * @param string $name
+     * @return string
+     */
+    public static function getPattern(string $name): string {
+        return static::get($name)['pattern'];
+    }
+
+    /**
+     * Return true if a constraint has been registered.
+     *
+     * @param string $name
+     * @return bool
+     */
+    public static function has(string $name): bool {
+        static::loadDefaults();
+
+        return static::$constraints->contains($name);
+    }
+
+    /**
+     * Validate a value against a constraint without evaluating its regex pattern.
+     *
+     * @param string $name
+     * @param string $value
+     * @return bool
+     */
+    public static function validate(string $name, string $value): bool {
+        $validator = static::get($name)['validator'];
+
+        return $validator($value);
+    }
+
+    /**
+     * Register the built-in constraints.
+     */
+    protected static function loadDefaults(): void {
+        if (static::$loaded) {
+            return;
+        }
+
+        static::$loaded = true;
+
+        static::add('int', '([0-9]+)', $value ==> ctype_digit($value));
+        static::add('alpha', '([a-zA-Z]+)', $value ==> ctype_alpha($value));
+        static::add('alnum', '([a-zA-Z0-9]+)', $value ==> ctype_alnum($value));
+        static::add('slug', '([a-zA-Z0-9\-\_]+)', $value ==> ($value !== '' && strspn(strtolower($value), 'abcdefghijklmnopqrstuvwxyz0123456789-_') === strlen($value)));
+        static::add('locale', Route::LOCALE, $value ==> (
+            (strlen($value) === 2 && ctype_alpha($value)) ||
+            (strlen($value) === 5 && $value[2] === '-' && ctype_alpha(substr($value, 0, 2) . substr($value, 3)))
+        ));
+
+        // Regular tokens, like `{id}`, `[id]`, and `(id)`, are validated by the kind of token
+        static::add('{}', Route::ALNUM, $value ==> ($value !== '' && strspn($value, 'abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-.') === strlen($value)));
+        static::add('[]', Route::NUMERIC, $value ==> ($value !== '' && strspn($value, '0123456789.') === strlen($value)));
+        static::add('()', Route::WILDCARD, $value ==> ($value !== '' && strpos($value, '/') === false));
+        static::add('uuid', '([0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12})', $value ==> (
+            strlen($value) === 36 &&
+            $value[8] === '-' && $value[13] === '-' && $value[18] === '-' && $value[23] === '-' &&
+            substr_count($value, '-') === 4 &&
+            ctype_xdigit(str_replace('-', '', $value))
+        ));
+    }
+
+}
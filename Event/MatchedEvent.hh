@@ -8,12 +8,13 @@
 namespace Titon\Route\Event;
 
 use Titon\Event\Event;
+use Titon\Route\MatchResult;
 use Titon\Route\Route;
 use Titon\Route\Router;
 
 /**
  * The route event that occurs after the route is matched.
- * The matched route is passed to the event.
+ * The match result is passed to the event.
  *
  * @package Titon\Route\Event
  */
@@ -27,32 +28,41 @@ class MatchedEvent extends Event {
     protected Router $router;
 
     /**
-     * The matched route.
+     * The match result.
      *
-     * @var \Titon\Route\Route
+     * @var \Titon\Route\MatchResult
      */
-    protected Route $route;
+    protected MatchResult $result;
 
     /**
      * Store the event settings.
      *
      * @param \Titon\Route\Router $router
-     * @param \Titon\Route\Route $route
+     * @param \Titon\Route\MatchResult $result
      */
-    public function __construct(Router $router, Route $route) {
+    public function __construct(Router $router, MatchResult $result) {
         $this->router = $router;
-        $this->route = $route;
+        $this->result = $result;
 
         parent::__construct('route.matched');
     }
 
     /**
-     * Return the route.
+     * Return the match result.
+     *
+     * @return \Titon\Route\MatchResult
+     */
+    public function getResult(): MatchResult {
+        return $this->result;
+    }
+
+    /**
+     * Return the matched route.
      *
      * @return \Titon\Route\Route
      */
     public function getRoute(): Route {
-        return $this->route;
+        return $this->result->getRoute();
     }
 
     /**
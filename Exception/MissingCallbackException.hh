@@ -0,0 +1,17 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Exception;
+
+/**
+ * Exception thrown when a callback or condition cannot be found by name.
+ *
+ * @package Titon\Route\Exception
+ */
+class MissingCallbackException extends \OutOfRangeException {
+
+}
@@ -17,12 +17,12 @@ interface Filter {
 
     /**
      * Method to be triggered once a route has been matched.
-     * The matching route and the router are passed as arguments.
+     * The match result and the router are passed as arguments.
      *
      * @param \Titon\Route\Router $router
-     * @param \Titon\Route\Route $route
+     * @param \Titon\Route\MatchResult $result
      * @return void
      */
-    public function filter(Router $router, Route $route): void;
+    public function filter(Router $router, MatchResult $result): void;
 
 }
\ No newline at end of file
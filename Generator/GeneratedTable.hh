@@ -0,0 +1,33 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Generator;
+
+/**
+ * The base for route tables generated by `Titon\Route\Generator\RouteTableGenerator`.
+ * The generated class returns the compiled route table as a static array literal,
+ * which is kept in the bytecode cache, and can be loaded into the router with `Router::loadTable()`.
+ *
+ * @package Titon\Route\Generator
+ */
+abstract class GeneratedTable {
+
+    /**
+     * Return the fingerprint of the route table the class was generated from.
+     *
+     * @return string
+     */
+    abstract public function getFingerprint(): string;
+
+    /**
+     * Return the route table in the format of `Titon\Route\RouteSerializer::dehydrate()`.
+     *
+     * @return array<string, mixed>
+     */
+    abstract public function getTable(): array<string, mixed>;
+
+}
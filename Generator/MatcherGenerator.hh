@@ -0,0 +1,234 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Generator;
+
+use Titon\Route\Matcher\TrieMatcher;
+use Titon\Route\PathPartList;
+use Titon\Route\Router;
+
+/**
+ * Generates the source of a standalone matcher that is specialized for the routes mapped in a router.
+ * Literal segments are resolved with nested strict comparisons and token segments with per-segment patterns,
+ * so that no loop over route objects is required to find the routes that could match.
+ * The fingerprint of the route table is embedded in the generated class, so that a stale matcher is rejected by the router.
+ *
+ * @package Titon\Route\Generator
+ */
+class MatcherGenerator {
+
+    /**
+     * Router instance.
+     *
+     * @var \Titon\Route\Router
+     */
+    protected Router $router;
+
+    /**
+     * Store the Router instance.
+     *
+     * @param \Titon\Route\Router $router
+     */
+    public function __construct(Router $router) {
+        $this->router = $router;
+    }
+
+    /**
+     * Generate the source for a matcher class with the defined fully qualified name.
+     *
+     * @param string $class
+     * @return string
+     */
+    public function generate(string $class): string {
+        $router = $this->getRouter();
+        $namespace = '';
+
+        if (($pos = strrpos($class, '\\')) !== false) {
+            $namespace = substr($class, 0, $pos);
+            $class = substr($class, $pos + 1);
+        }
+
+        $lines = Vector {
+            '<?hh // strict',
+            '/**',
+            ' * Generated by Titon\Route\Generator\MatcherGenerator. Do not modify this file,',
+            ' * it must be regenerated whenever the mapped routes change.',
+            ' */',
+            ''
+        };
+
+        if ($namespace) {
+            $lines->addAll(Vector {sprintf('namespace %s;', $namespace), ''});
+        }
+
+        $lines->addAll(Vector {
+            'use Titon\Route\Matcher\GeneratedMatcher;',
+            '',
+            sprintf('class %s extends GeneratedMatcher {', $class),
+            '',
+            sprintf('    const string FINGERPRINT = %s;', var_export($router->getFingerprint(), true)),
+            '',
+            '    public function getFingerprint(): string {',
+            '        return self::FINGERPRINT;',
+            '    }',
+            '',
+            '    protected function getCandidateKeys(Vector<string> $s): array<int, string> {',
+            '        $n = $s->count();',
+            '        $c = [];',
+            ''
+        });
+
+        $lines->addAll($this->generateNode($this->buildTree(), 0, 2));
+
+        $lines->addAll(Vector {
+            '',
+            '        ksort($c);',
+            '',
+            '        return $c;',
+            '    }',
+            '',
+            '}',
+            ''
+        });
+
+        return implode("\n", $lines);
+    }
+
+    /**
+     * Return the Router instance.
+     *
+     * @return \Titon\Route\Router
+     */
+    public function getRouter(): Router {
+        return $this->router;
+    }
+
+    /**
+     * Generate the matcher source and write it to the defined file path.
+     *
+     * @param string $class
+     * @param string $path
+     * @return bool
+     */
+    public function write(string $class, string $path): bool {
+        return (file_put_contents($path, $this->generate($class)) !== false);
+    }
+
+    /**
+     * Build a segment tree from the path segments of every mapped route.
+     *
+     * @return \Titon\Route\Generator\Node
+     */
+    protected function buildTree(): Node {
+        $root = new Node();
+        $position = 0;
+
+        foreach ($this->getRouter()->getRoutes() as $key => $route) {
+            $node = $root;
+            $terminated = true;
+
+            foreach ($route->getSegments() as $segment) {
+                $first = $segment[0];
+
+                // Segments are compared against the lowercased URL, so literals are lowercased as well
+                if ($segment->count() === 1 && $first['type'] === 'literal') {
+                    $node = $node->literal(strtolower($first['value']));
+
+                } else if (TrieMatcher::isSegment($route, $segment)) {
+                    $node = $node->dynamic($this->compileSegment($segment));
+
+                } else {
+                    $node->addFallback($position, $key);
+                    $terminated = false;
+                    break;
+                }
+            }
+
+            if ($terminated) {
+                $node->addRoute($position, $key);
+            }
+
+            $position++;
+        }
+
+        return $root;
+    }
+
+    /**
+     * Compile the parts of a segment into a standalone regex. Every token in the segment must be validated
+     * by a constraint, so that its pattern can never match across a slash.
+     *
+     * @param \Titon\Route\PathPartList $segment
+     * @return string
+     */
+    protected function compileSegment(PathPartList $segment): string {
+        $regex = '';
+
+        foreach ($segment as $part) {
+            $regex .= ($part['type'] === 'literal') ? preg_quote($part['value'], '~') : $part['pattern'];
+        }
+
+        return '~^' . $regex . '$~i';
+    }
+
+    /**
+     * Generate the source lines that collect candidates for a node and all of its children.
+     *
+     * @param \Titon\Route\Generator\Node $node
+     * @param int $depth
+     * @param int $indent
+     * @return Vector<string>
+     */
+    protected function generateNode(Node $node, int $depth, int $indent): Vector<string> {
+        $pad = str_repeat('    ', $indent);
+        $lines = Vector {};
+
+        foreach ($node->getFallback() as $position => $key) {
+            $lines[] = $pad . sprintf('$c[%s] = %s;', $position, var_export($key, true));
+        }
+
+        if ($routes = $node->getRoutes()) {
+            $lines[] = $pad . sprintf('if ($n === %s) {', $depth);
+
+            foreach ($routes as $position => $key) {
+                $lines[] = $pad . sprintf('    $c[%s] = %s;', $position, var_export($key, true));
+            }
+
+            $lines[] = $pad . '}';
+        }
+
+        if (!$node->getStatic() && !$node->getDynamic()) {
+            return $lines;
+        }
+
+        $lines[] = $pad . sprintf('if ($n > %s) {', $depth);
+
+        // Compare strictly, as switch compares loosely, and numeric segments like "01" and "1" would be equal
+        if ($static = $node->getStatic()) {
+            $else = '';
+
+            foreach ($static as $segment => $child) {
+                $lines[] = $pad . sprintf('    %sif ($s[%s] === %s) {', $else, $depth, var_export((string) $segment, true));
+                $lines->addAll($this->generateNode($child, $depth + 1, $indent + 2));
+                $else = '} else ';
+            }
+
+            $lines[] = $pad . '    }';
+        }
+
+        foreach ($node->getDynamic() as $regex => $child) {
+            $lines[] = $pad . sprintf('    if (preg_match(%s, $s[%s])) {', var_export($regex, true), $depth);
+            $lines->addAll($this->generateNode($child, $depth + 1, $indent + 2));
+            $lines[] = $pad . '    }';
+        }
+
+        $lines[] = $pad . '}';
+
+        return $lines;
+    }
+
+}
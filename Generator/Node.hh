@@ -0,0 +1,139 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Generator;
+
+/**
+ * A single segment node within the tree used by the `MatcherGenerator`.
+ * Unlike the `TrieNode`, dynamic children are keyed by the regex of their segment,
+ * so that each token can be validated before descending.
+ *
+ * @package Titon\Route\Generator
+ */
+class Node {
+
+    /**
+     * Child nodes keyed by the regex of the segment.
+     *
+     * @var Map<string, \Titon\Route\Generator\Node>
+     */
+    protected Map<string, Node> $dynamic = Map {};
+
+    /**
+     * Routes that match any URL reaching this node, and must be resolved with regex.
+     *
+     * @var Map<int, string>
+     */
+    protected Map<int, string> $fallback = Map {};
+
+    /**
+     * Routes whose path terminates at this node.
+     *
+     * @var Map<int, string>
+     */
+    protected Map<int, string> $routes = Map {};
+
+    /**
+     * Child nodes keyed by a lowercased literal segment.
+     *
+     * @var Map<string, \Titon\Route\Generator\Node>
+     */
+    protected Map<string, Node> $static = Map {};
+
+    /**
+     * Add a route that must be resolved with regex once this node is reached.
+     *
+     * @param int $position
+     * @param string $key
+     * @return $this
+     */
+    public function addFallback(int $position, string $key): this {
+        $this->fallback[$position] = $key;
+
+        return $this;
+    }
+
+    /**
+     * Add a route that terminates at this node.
+     *
+     * @param int $position
+     * @param string $key
+     * @return $this
+     */
+    public function addRoute(int $position, string $key): this {
+        $this->routes[$position] = $key;
+
+        return $this;
+    }
+
+    /**
+     * Return the child node for a segment regex, creating it if it does not exist.
+     *
+     * @param string $regex
+     * @return \Titon\Route\Generator\Node
+     */
+    public function dynamic(string $regex): Node {
+        if (!$this->dynamic->contains($regex)) {
+            $this->dynamic[$regex] = new Node();
+        }
+
+        return $this->dynamic[$regex];
+    }
+
+    /**
+     * Return all dynamic child nodes.
+     *
+     * @return Map<string, \Titon\Route\Generator\Node>
+     */
+    public function getDynamic(): Map<string, Node> {
+        return $this->dynamic;
+    }
+
+    /**
+     * Return all fallback routes.
+     *
+     * @return Map<int, string>
+     */
+    public function getFallback(): Map<int, string> {
+        return $this->fallback;
+    }
+
+    /**
+     * Return all terminating routes.
+     *
+     * @return Map<int, string>
+     */
+    public function getRoutes(): Map<int, string> {
+        return $this->routes;
+    }
+
+    /**
+     * Return all literal child nodes.
+     *
+     * @return Map<string, \Titon\Route\Generator\Node>
+     */
+    public function getStatic(): Map<string, Node> {
+        return $this->static;
+    }
+
+    /**
+     * Return the child node for a literal segment, creating it if it does not exist.
+     *
+     * @param string $segment
+     * @return \Titon\Route\Generator\Node
+     */
+    public function literal(string $segment): Node {
+        $segment = strtolower($segment);
+
+        if (!$this->static->contains($segment)) {
+            $this->static[$segment] = new Node();
+        }
+
+        return $this->static[$segment];
+    }
+
+}
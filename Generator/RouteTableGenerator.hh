@@ -0,0 +1,151 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Generator;
+
+use Titon\Route\Router;
+use \Exception;
+
+/**
+ * Generates the source of a class that contains the fully compiled route table as a static array literal,
+ * so that routes can be loaded without storage I/O or unserialization. Every route is validated beforehand,
+ * and a report can be generated that lists the compiled routes and any problems found.
+ *
+ * @package Titon\Route\Generator
+ */
+class RouteTableGenerator {
+
+    /**
+     * Router instance.
+     *
+     * @var \Titon\Route\Router
+     */
+    protected Router $router;
+
+    /**
+     * Store the Router instance.
+     *
+     * @param \Titon\Route\Router $router
+     */
+    public function __construct(Router $router) {
+        $this->router = $router;
+    }
+
+    /**
+     * Generate the source for a route table class with the defined fully qualified name.
+     *
+     * @param string $class
+     * @return string
+     * @throws \Titon\Route\Exception\MissingPatternException
+     */
+    public function generate(string $class): string {
+        $router = $this->getRouter();
+        $table = $router->getSerializer()->dehydrate($router->getRoutes());
+        $namespace = '';
+
+        if (($pos = strrpos($class, '\\')) !== false) {
+            $namespace = substr($class, 0, $pos);
+            $class = substr($class, $pos + 1);
+        }
+
+        $lines = Vector {
+            '<?hh // strict',
+            '/**',
+            ' * Generated by Titon\Route\Generator\RouteTableGenerator. Do not modify this file,',
+            ' * it must be regenerated whenever the mapped routes change.',
+            ' */',
+            ''
+        };
+
+        if ($namespace) {
+            $lines->addAll(Vector {sprintf('namespace %s;', $namespace), ''});
+        }
+
+        $lines->addAll(Vector {
+            'use Titon\Route\Generator\GeneratedTable;',
+            '',
+            sprintf('class %s extends GeneratedTable {', $class),
+            '',
+            sprintf('    const string FINGERPRINT = %s;', var_export($router->getFingerprint(), true)),
+            '',
+            '    public function getFingerprint(): string {',
+            '        return self::FINGERPRINT;',
+            '    }',
+            '',
+            '    public function getTable(): array<string, mixed> {',
+            '        return ' . str_replace("\n", "\n        ", var_export($table, true)) . ';',
+            '    }',
+            '',
+            '}',
+            ''
+        });
+
+        return implode("\n", $lines);
+    }
+
+    /**
+     * Return the Router instance.
+     *
+     * @return \Titon\Route\Router
+     */
+    public function getRouter(): Router {
+        return $this->router;
+    }
+
+    /**
+     * Compile and validate every mapped route, and return a report that lists each route with its methods,
+     * path, regex, and compile time. Routes that failed to compile, or that have callbacks or conditions
+     * which are not registered in the callback registry, and can therefore not be exported, are listed as errors.
+     *
+     * @return string
+     */
+    public function report(): string {
+        $lines = Vector {};
+        $errors = 0;
+
+        foreach ($this->getRouter()->getRoutes() as $key => $route) {
+            $start = microtime(true);
+
+            try {
+                $regex = $route->getRegex();
+                $route->getHostRegex();
+            } catch (Exception $e) {
+                $lines[] = sprintf('[error] %s %s: %s', $key, $route->getPath(), $e->getMessage());
+                $errors++;
+                continue;
+            }
+
+            $lines[] = sprintf('%s %s %s %s (%.3fms)',
+                $key,
+                $route->getMethods() ? strtoupper(implode(',', $route->getMethods())) : 'ANY',
+                $route->getPath(),
+                $regex,
+                (microtime(true) - $start) * 1000);
+
+            if (!$route->isCacheable()) {
+                $lines[] = sprintf('[error] %s: callbacks and conditions must be registered in the callback registry to be exported', $key);
+                $errors++;
+            }
+        }
+
+        $lines[] = sprintf('%s routes, %s errors', $this->getRouter()->getRoutes()->count(), $errors);
+
+        return implode("\n", $lines);
+    }
+
+    /**
+     * Generate the route table source and write it to the defined file path.
+     *
+     * @param string $class
+     * @param string $path
+     * @return bool
+     */
+    public function write(string $class, string $path): bool {
+        return (file_put_contents($path, $this->generate($class)) !== false);
+    }
+
+}
@@ -8,7 +8,9 @@
 namespace Titon\Route;
 
 use Titon\Route\Mixin\ConditionMixin;
+use Titon\Route\Mixin\ConstraintMixin;
 use Titon\Route\Mixin\FilterMixin;
+use Titon\Route\Mixin\HostMixin;
 use Titon\Route\Mixin\MethodMixin;
 use Titon\Route\Mixin\PatternMixin;
 use Titon\Route\Mixin\SecureMixin;
@@ -20,7 +22,7 @@ use Titon\Route\Mixin\SecureMixin;
  * @package Titon\Route
  */
 class Group {
-    use ConditionMixin, FilterMixin, MethodMixin, PatternMixin, SecureMixin;
+    use ConditionMixin, ConstraintMixin, FilterMixin, HostMixin, MethodMixin, PatternMixin, SecureMixin;
 
     /**
      * Prefix to prepend to all route paths.
@@ -7,6 +7,8 @@
 
 namespace Titon\Route;
 
+use Titon\Route\Mixin\PatternMap;
+
 /**
  * Prepends all routes with a locale matching pattern.
  *
@@ -15,22 +17,33 @@ namespace Titon\Route;
 class LocaleRoute extends Route {
 
     /**
-     * Prepend the locale to the front of the route before compilation.
+     * Return the path with the locale prepended to the front, without modifying the defined path.
      *
      * @return string
      */
-    public function compile(): string {
-        if ($this->isCompiled()) {
-            return $this->compiled;
-        }
+    public function getPath(): string {
+        $path = parent::getPath();
 
-        if (mb_substr($this->getPath(), 0, 9) !== '/<locale>') {
-            $this->prepend('/<locale>');
+        if (mb_substr($path, 0, 9) === '/<locale>') {
+            return $path;
         }
 
-        $this->addPattern('locale', self::LOCALE);
+        return '/<locale>' . rtrim($path, '/');
+    }
+
+    /**
+     * Return the patterns with the locale pattern included, without modifying the defined patterns.
+     *
+     * @return \Titon\Route\Mixin\PatternMap
+     */
+    public function getPatterns(): PatternMap {
+        $patterns = parent::getPatterns();
+
+        if ($patterns->contains('locale')) {
+            return $patterns;
+        }
 
-        return parent::compile();
+        return $patterns->toMap()->set('locale', self::LOCALE);
     }
 
 }
@@ -0,0 +1,167 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+/**
+ * The LruCache stores a bounded amount of entries in memory, keyed by string, and evicts them
+ * in least recently used order. It is the base for the match and miss caches, and is used to bound
+ * lookups that are keyed by client provided values, like host names.
+ *
+ * @package Titon\Route
+ */
+class LruCache<Tv> {
+
+    /**
+     * Cached entries in least to most recently used order.
+     *
+     * @var Map<string, Tv>
+     */
+    protected Map<string, Tv> $entries = Map {};
+
+    /**
+     * Amount of lookups that returned an entry.
+     *
+     * @var int
+     */
+    protected int $hits = 0;
+
+    /**
+     * Maximum amount of entries to store.
+     *
+     * @var int
+     */
+    protected int $limit;
+
+    /**
+     * Amount of lookups that did not return an entry.
+     *
+     * @var int
+     */
+    protected int $misses = 0;
+
+    /**
+     * Set the entry limit.
+     *
+     * @param int $limit
+     */
+    public function __construct(int $limit) {
+        $this->limit = max(1, $limit);
+    }
+
+    /**
+     * Return true if an entry exists, without marking it as used.
+     *
+     * @param string $key
+     * @return bool
+     */
+    public function contains(string $key): bool {
+        return $this->entries->contains($key);
+    }
+
+    /**
+     * Return the amount of cached entries.
+     *
+     * @return int
+     */
+    public function count(): int {
+        return $this->entries->count();
+    }
+
+    /**
+     * Remove all cached entries.
+     *
+     * @return $this
+     */
+    public function flush(): this {
+        $this->entries->clear();
+
+        return $this;
+    }
+
+    /**
+     * Return a cached entry and mark it as the most recently used, or null if it does not exist.
+     *
+     * @param string $key
+     * @return Tv
+     */
+    public function get(string $key): ?Tv {
+        if (!$this->entries->contains($key)) {
+            $this->misses++;
+
+            return null;
+        }
+
+        $entry = $this->entries[$key];
+
+        // Move to the end of the map
+        $this->entries->remove($key);
+        $this->entries[$key] = $entry;
+        $this->hits++;
+
+        return $entry;
+    }
+
+    /**
+     * Return the amount of lookups that returned an entry.
+     *
+     * @return int
+     */
+    public function getHits(): int {
+        return $this->hits;
+    }
+
+    /**
+     * Return the maximum amount of entries.
+     *
+     * @return int
+     */
+    public function getLimit(): int {
+        return $this->limit;
+    }
+
+    /**
+     * Return the amount of lookups that did not return an entry.
+     *
+     * @return int
+     */
+    public function getMisses(): int {
+        return $this->misses;
+    }
+
+    /**
+     * Remove a cached entry.
+     *
+     * @param string $key
+     * @return $this
+     */
+    public function remove(string $key): this {
+        $this->entries->remove($key);
+
+        return $this;
+    }
+
+    /**
+     * Set a cached entry, evicting the least recently used entry if the limit has been reached.
+     *
+     * @param string $key
+     * @param Tv $entry
+     * @return $this
+     */
+    public function set(string $key, Tv $entry): this {
+        $this->entries->remove($key);
+
+        if ($this->entries->count() >= $this->getLimit() && ($oldest = $this->entries->firstKey()) !== null) {
+            $this->entries->remove($oldest);
+        }
+
+        $this->entries[$key] = $entry;
+
+        return $this;
+    }
+
+}
@@ -0,0 +1,39 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+/**
+ * The MatchCache stores the results of previous matches in memory so that repeated URLs
+ * can be resolved without running the matcher. Entries are bounded and evicted in least recently used order.
+ * Should be flushed whenever the route table changes.
+ *
+ * @package Titon\Route
+ */
+class MatchCache extends LruCache<MatchResult> {
+
+    /**
+     * Set the entry limit.
+     *
+     * @param int $limit
+     */
+    public function __construct(int $limit = 1000) {
+        parent::__construct($limit);
+    }
+
+    /**
+     * Generate a cache key for a request.
+     *
+     * @param \Titon\Route\RequestContext $context
+     * @param string $url
+     * @return string
+     */
+    public static function key(RequestContext $context, string $url): string {
+        return implode('|', [$context->getMethod(), $context->getScheme(), $context->getHost(), $url]);
+    }
+
+}
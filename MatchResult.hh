@@ -0,0 +1,116 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+/**
+ * An immutable representation of a single successful match. Pairs the matched route with the URL
+ * and params of the current request, so that route definitions remain read-only and can be shared.
+ *
+ * @package Titon\Route
+ */
+class MatchResult {
+
+    /**
+     * The key of the matched route.
+     *
+     * @var string
+     */
+    protected string $key;
+
+    /**
+     * Params gathered from the path and host tokens.
+     *
+     * @var ImmMap<string, mixed>
+     */
+    protected ImmMap<string, mixed> $params;
+
+    /**
+     * The matched route.
+     *
+     * @var \Titon\Route\Route
+     */
+    protected Route $route;
+
+    /**
+     * The URL that was matched.
+     *
+     * @var string
+     */
+    protected string $url;
+
+    /**
+     * Store the match settings.
+     *
+     * @param string $key
+     * @param \Titon\Route\Route $route
+     * @param string $url
+     * @param ImmMap<string, mixed> $params
+     */
+    public function __construct(string $key, Route $route, string $url, ImmMap<string, mixed> $params = ImmMap {}) {
+        $this->key = $key;
+        $this->route = $route;
+        $this->url = $url;
+        $this->params = $params;
+    }
+
+    /**
+     * Dispatch the matched route to its action or callback using the matched params.
+     *
+     * @return mixed
+     */
+    public function dispatch(): mixed {
+        return $this->getRoute()->dispatch($this);
+    }
+
+    /**
+     * Return the key of the matched route.
+     *
+     * @return string
+     */
+    public function getKey(): string {
+        return $this->key;
+    }
+
+    /**
+     * Return a param by key.
+     *
+     * @param string $key
+     * @return mixed
+     */
+    public function getParam(string $key): mixed {
+        return $this->getParams()->get($key);
+    }
+
+    /**
+     * Return all params.
+     *
+     * @return ImmMap<string, mixed>
+     */
+    public function getParams(): ImmMap<string, mixed> {
+        return $this->params;
+    }
+
+    /**
+     * Return the matched route.
+     *
+     * @return \Titon\Route\Route
+     */
+    public function getRoute(): Route {
+        return $this->route;
+    }
+
+    /**
+     * Return the matched URL.
+     *
+     * @return string
+     */
+    public function url(): string {
+        return $this->url;
+    }
+
+}
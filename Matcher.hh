@@ -15,12 +15,24 @@ namespace Titon\Route;
 interface Matcher {
 
     /**
-     * Attempt to match a route against a URL.
+     * Attempt to match a route against a URL asynchronously. Conditions of all candidate routes are evaluated concurrently,
+     * while the result of the first route that matches, in the order they were mapped, is returned.
      *
      * @param string $url
      * @param \Titon\Route\RouteMap $routes
-     * @return \Titon\Route\Route
+     * @param \Titon\Route\RequestContext $context
+     * @return Awaitable<\Titon\Route\MatchResult>
      */
-    public function match(string $url, RouteMap $routes): ?Route;
+    public function genMatch(string $url, RouteMap $routes, RequestContext $context): Awaitable<?MatchResult>;
+
+    /**
+     * Attempt to match a route against a URL, and return the result of the first route that matches.
+     *
+     * @param string $url
+     * @param \Titon\Route\RouteMap $routes
+     * @param \Titon\Route\RequestContext $context
+     * @return \Titon\Route\MatchResult
+     */
+    public function match(string $url, RouteMap $routes, RequestContext $context): ?MatchResult;
 
 }
\ No newline at end of file
@@ -0,0 +1,102 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Matcher;
+
+use Titon\Route\LruCache;
+use Titon\Route\RouteMap;
+use Titon\Route\Router;
+
+/**
+ * Provides shared functionality for matchers that build a lookup index from the route table.
+ * Indexes are built lazily on the first match and rebuilt when the route table changes.
+ *
+ * @package Titon\Route\Matcher
+ */
+abstract class AbstractIndexMatcher<Tindex> extends AbstractMatcher {
+
+    /**
+     * Built indexes, keyed by the object hash of the route map they were built from.
+     * Route maps are partitioned by method, host, and rules, so the amount of indexes is bounded.
+     *
+     * @var \Titon\Route\LruCache<shape('routes' => RouteMap, 'count' => int, 'index' => Tindex)>
+     */
+    protected LruCache<shape('routes' => RouteMap, 'count' => int, 'index' => Tindex)> $indexes;
+
+    /**
+     * Set the index limit.
+     *
+     * @param int $limit
+     */
+    public function __construct(int $limit = 100) {
+        $this->indexes = new LruCache($limit);
+    }
+
+    /**
+     * Remove all built indexes so that they are rebuilt on the next match.
+     *
+     * @return $this
+     */
+    public function flush(): this {
+        $this->indexes->flush();
+
+        return $this;
+    }
+
+    /**
+     * Build an index for the defined routes.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @return Tindex
+     */
+    abstract protected function buildIndex(RouteMap $routes): Tindex;
+
+    /**
+     * Return true if any route matches case-insensitively, in which case literal index keys must be lowercased,
+     * so that the index produces every possible candidate. Otherwise keys are compared byte for byte.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @return bool
+     */
+    protected function foldsCase(RouteMap $routes): bool {
+        foreach ($routes as $route) {
+            if ($route->getCasePolicy() === Router::CASE_INSENSITIVE) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Return the index for the defined routes, building it if it does not exist, or if the size of the route map
+     * changed since it was built. Replacing a route in a map does not change its size, so `flush()` must be called
+     * whenever a route map is modified. The router does this whenever a route is mapped.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @return Tindex
+     */
+    protected function getIndex(RouteMap $routes): Tindex {
+        $key = spl_object_hash($routes);
+        $cache = $this->indexes->get($key);
+
+        if ($cache !== null && $cache['routes'] === $routes && $cache['count'] === $routes->count()) {
+            return $cache['index'];
+        }
+
+        $index = $this->buildIndex($routes);
+
+        $this->indexes->set($key, shape(
+            'routes' => $routes,
+            'count' => $routes->count(),
+            'index' => $index
+        ));
+
+        return $index;
+    }
+
+}
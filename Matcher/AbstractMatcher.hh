@@ -0,0 +1,94 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Matcher;
+
+use Titon\Route\Matcher;
+use Titon\Route\MatchResult;
+use Titon\Route\RequestContext;
+use Titon\Route\Route;
+use Titon\Route\RouteMap;
+
+/**
+ * Provides shared functionality for matchers that resolve a list of candidate routes,
+ * which are then validated in the order they were mapped.
+ *
+ * @package Titon\Route\Matcher
+ */
+abstract class AbstractMatcher implements Matcher {
+
+    /**
+     * {@inheritdoc}
+     */
+    public async function genMatch(string $url, RouteMap $routes, RequestContext $context): Awaitable<?MatchResult> {
+        $results = Vector {};
+
+        // Gather every candidate that matches the path, up until the first one without conditions
+        foreach ($this->getCandidates($url, $routes) as $key => $route) {
+            $result = $this->matchCandidate($url, $routes, $key, $route, $context);
+
+            if ($result === null) {
+                continue;
+            }
+
+            $results[] = $result;
+
+            if (!$route->hasConditions()) {
+                break;
+            }
+        }
+
+        // Evaluate the conditions of all candidates concurrently, and return the first mapped that passes
+        $valid = await \HH\Asio\v($results->map($result ==> $result->getRoute()->genValid($context)));
+
+        foreach ($results as $i => $result) {
+            if ($valid[$i]) {
+                return $result;
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function match(string $url, RouteMap $routes, RequestContext $context): ?MatchResult {
+        foreach ($this->getCandidates($url, $routes) as $key => $route) {
+            if (($result = $this->matchCandidate($url, $routes, $key, $route, $context)) && $route->isValid($context)) {
+                return $result;
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * Yield every route that could potentially match the URL, keyed by route key, in the order they were mapped.
+     *
+     * @param string $url
+     * @param \Titon\Route\RouteMap $routes
+     * @return KeyedIterator<string, \Titon\Route\Route>
+     */
+    abstract protected function getCandidates(string $url, RouteMap $routes): KeyedIterator<string, Route>;
+
+    /**
+     * Match a candidate route against the URL without validating conditions.
+     * Matchers that resolve token values while finding candidates can skip the path regex.
+     *
+     * @param string $url
+     * @param \Titon\Route\RouteMap $routes
+     * @param string $key
+     * @param \Titon\Route\Route $route
+     * @param \Titon\Route\RequestContext $context
+     * @return \Titon\Route\MatchResult
+     */
+    protected function matchCandidate(string $url, RouteMap $routes, string $key, Route $route, RequestContext $context): ?MatchResult {
+        return $route->matchPath($url, $context, $key);
+    }
+
+}
@@ -0,0 +1,147 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Matcher;
+
+use Titon\Route\Route;
+use Titon\Route\RouteMap;
+use Titon\Route\Router;
+
+/**
+ * Merges the compiled regex of multiple routes into chunks of large alternation patterns,
+ * so that a lookup requires a single regex evaluation per chunk instead of per route.
+ * The route that matched is determined by an empty marker group that trails each alternative.
+ * Routes with named groups or backreferences in their patterns can not be combined, so they are matched on their own.
+ *
+ * @package Titon\Route\Matcher
+ */
+class CombinedMatcher extends AbstractIndexMatcher<CombinedIndex> {
+
+    /**
+     * Regex to detect named groups, backreferences, subroutine calls, and branch resets within a compiled pattern.
+     */
+    const string UNSAFE = '/\(\?(?:P?<[a-z_]|P[=>]|\'|&|\||R\)|[-+]?[0-9]+\))|\\\\(?:[1-9]|g|k)/i';
+
+    /**
+     * Amount of routes to combine into a single regex pattern.
+     *
+     * @var int
+     */
+    protected int $chunkSize;
+
+    /**
+     * Set the chunk size.
+     *
+     * @param int $chunkSize
+     */
+    public function __construct(int $chunkSize = 25) {
+        parent::__construct();
+
+        $this->chunkSize = max(1, $chunkSize);
+    }
+
+    /**
+     * Return the chunk size.
+     *
+     * @return int
+     */
+    public function getChunkSize(): int {
+        return $this->chunkSize;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    protected function buildIndex(RouteMap $routes): CombinedIndex {
+        $index = Vector {};
+        $keyList = Vector {};
+        $routeList = Vector {};
+        $patterns = [];
+        $modifiers = '';
+
+        foreach ($routes as $key => $route) {
+            $compiled = $route->compile();
+
+            // Groups in the pattern would collide with, or renumber, the groups of other routes in the chunk
+            if (preg_match(self::UNSAFE, $compiled)) {
+                if ($patterns) {
+                    $index[] = shape('keys' => $keyList, 'regex' => '~^(?:' . implode('|', $patterns) . ')$~' . $modifiers, 'routes' => $routeList);
+                    $keyList = Vector {};
+                    $routeList = Vector {};
+                    $patterns = [];
+                    $modifiers = '';
+                }
+
+                $index[] = shape('keys' => Vector {$key}, 'regex' => $route->getRegex(), 'routes' => Vector {$route});
+                continue;
+            }
+
+            $patterns[] = '(?:' . $compiled . ')(?<r' . $routeList->count() . '>)';
+
+            // A case-insensitive chunk can only produce more candidates, which are then validated by each route
+            if ($route->getCasePolicy() === Router::CASE_INSENSITIVE) {
+                $modifiers = 'i';
+            }
+            $keyList[] = $key;
+            $routeList[] = $route;
+
+            if ($routeList->count() >= $this->getChunkSize()) {
+                $index[] = shape('keys' => $keyList, 'regex' => '~^(?:' . implode('|', $patterns) . ')$~' . $modifiers, 'routes' => $routeList);
+                $keyList = Vector {};
+                $routeList = Vector {};
+                $patterns = [];
+                $modifiers = '';
+            }
+        }
+
+        if ($patterns) {
+            $index[] = shape('keys' => $keyList, 'regex' => '~^(?:' . implode('|', $patterns) . ')$~' . $modifiers, 'routes' => $routeList);
+        }
+
+        return $index;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    protected function getCandidates(string $url, RouteMap $routes): KeyedIterator<string, Route> {
+        foreach ($this->getIndex($routes) as $chunk) {
+            $matches = [];
+            $result = preg_match($chunk['regex'], $url, $matches);
+
+            // The pattern could not be evaluated, like when a limit is reached, so let each route match on its own
+            if ($result === false) {
+                foreach ($chunk['routes'] as $i => $route) {
+                    yield $chunk['keys'][$i] => $route;
+                }
+
+                continue;
+            }
+
+            if (!$result) {
+                continue;
+            }
+
+            // The last marker group captured belongs to the first alternative that matched
+            $routeList = $chunk['routes'];
+            $offset = 0;
+
+            for ($i = $routeList->count() - 1; $i >= 0; $i--) {
+                if (array_key_exists('r' . $i, $matches)) {
+                    $offset = $i;
+                    break;
+                }
+            }
+
+            // Methods, security, and conditions may still fail, so continue through the chunk
+            for ($i = $offset; $i < $routeList->count(); $i++) {
+                yield $chunk['keys'][$i] => $routeList[$i];
+            }
+        }
+    }
+
+}
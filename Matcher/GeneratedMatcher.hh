@@ -0,0 +1,54 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Matcher;
+
+use Titon\Route\Route;
+use Titon\Route\RouteMap;
+
+/**
+ * The base for matchers generated by `Titon\Route\Generator\MatcherGenerator`.
+ * The generated class resolves a list of candidate route keys from the URL segments,
+ * which are then validated in the order they were mapped.
+ *
+ * @package Titon\Route\Matcher
+ */
+abstract class GeneratedMatcher extends AbstractMatcher {
+
+    /**
+     * Return the fingerprint of the route table the matcher was generated from.
+     *
+     * @return string
+     */
+    abstract public function getFingerprint(): string;
+
+    /**
+     * {@inheritdoc}
+     */
+    protected function getCandidates(string $url, RouteMap $routes): KeyedIterator<string, Route> {
+        $segments = TrieMatcher::segment($url);
+
+        if ($segments === null) {
+            return;
+        }
+
+        foreach ($this->getCandidateKeys($segments) as $key) {
+            if ($routes->contains($key)) {
+                yield $key => $routes[$key];
+            }
+        }
+    }
+
+    /**
+     * Return the keys of all routes that could match the lowercased URL segments, in the order they were mapped.
+     *
+     * @param Vector<string> $segments
+     * @return array<int, string>
+     */
+    abstract protected function getCandidateKeys(Vector<string> $segments): array<int, string>;
+
+}
@@ -7,28 +7,118 @@
 
 namespace Titon\Route\Matcher;
 
-use Titon\Route\Matcher;
 use Titon\Route\Route;
 use Titon\Route\RouteMap;
+use Titon\Route\Router;
 
 /**
  * Loops through each route until a match is found.
+ * Static routes are indexed by their path so that they can be resolved with a single lookup,
+ * while only dynamic routes that can also match the path are looped over before them.
  *
  * @package Titon\Route\Matcher
  */
-class LoopMatcher implements Matcher {
+class LoopMatcher extends AbstractIndexMatcher<LoopIndex> {
+
+    /**
+     * Normalize a URL or path into a static index key by removing a trailing slash, and lowercasing if case is folded.
+     *
+     * @param string $url
+     * @param bool $fold
+     * @return string
+     */
+    public static function normalize(string $url, bool $fold = true): string {
+        if (strlen($url) > 1 && substr($url, -1) === '/') {
+            $url = substr($url, 0, -1);
+        }
+
+        return $fold ? strtolower($url) : $url;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    protected function buildIndex(RouteMap $routes): LoopIndex {
+        $index = shape(
+            'dynamic' => Vector {},
+            'fold' => $this->foldsCase($routes),
+            'keys' => Vector {},
+            'routes' => Vector {},
+            'shadows' => Map {},
+            'static' => Map {}
+        );
+
+        foreach ($routes as $key => $route) {
+            $position = $index['routes']->count();
+            $index['keys'][] = $key;
+            $index['routes'][] = $route;
+
+            $parts = $route->getParts();
+
+            // A path that compiles to a single literal part has no tokens, so can be looked up by path
+            if ($parts->count() === 1 && $parts[0]['type'] === 'literal') {
+                // Normalized routes expect a lowercased URL, so their paths are lowercased like the URL
+                $path = static::normalize($parts[0]['value'], $index['fold'] || $route->getCasePolicy() === Router::CASE_NORMALIZE);
+
+                if (!$index['static']->contains($path)) {
+                    $index['static'][$path] = Vector {};
+                }
+
+                $index['static'][$path][] = $position;
+            } else {
+                $index['dynamic'][] = $position;
+            }
+        }
+
+        return $index;
+    }
 
     /**
      * {@inheritdoc}
      */
-    public function match(string $url, RouteMap $routes): ?Route {
-        foreach ($routes as $route) {
-            if ($route->isMatch($url)) {
-                return $route;
+    protected function getCandidates(string $url, RouteMap $routes): KeyedIterator<string, Route> {
+        $index = $this->getIndex($routes);
+        $path = static::normalize($url, $index['fold']);
+
+        if ($index['static']->contains($path)) {
+            $positions = $this->getShadows($index, $path)->toValuesArray();
+            $positions = array_merge($positions, $index['static'][$path]->toArray());
+
+            sort($positions);
+        } else {
+            $positions = $index['dynamic'];
+        }
+
+        foreach ($positions as $position) {
+            yield $index['keys'][$position] => $index['routes'][$position];
+        }
+    }
+
+    /**
+     * Return the position of all dynamic routes that can also match a static path.
+     * The list is determined on the first lookup of each path and re-used afterwards.
+     *
+     * @param \Titon\Route\Matcher\LoopIndex $index
+     * @param string $path
+     * @return Set<int>
+     */
+    protected function getShadows(LoopIndex $index, string $path): Set<int> {
+        if ($index['shadows']->contains($path)) {
+            return $index['shadows'][$path];
+        }
+
+        $shadows = Set {};
+
+        foreach ($index['dynamic'] as $position) {
+            // Folded static paths must be compared case-insensitively to find every possible candidate
+            $regex = '~^' . $index['routes'][$position]->compile() . '$~' . ($index['fold'] ? 'i' : '');
+
+            if (preg_match($regex, $path) || preg_match($regex, $path . '/')) {
+                $shadows[] = $position;
             }
         }
 
-        return null;
+        return $index['shadows'][$path] = $shadows;
     }
 
-}
\ No newline at end of file
+}
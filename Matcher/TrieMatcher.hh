@@ -0,0 +1,214 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Matcher;
+
+use Titon\Route\MatchResult;
+use Titon\Route\PathPart;
+use Titon\Route\PathPartList;
+use Titon\Route\RequestContext;
+use Titon\Route\Route;
+use Titon\Route\RouteMap;
+use Titon\Route\Router;
+
+/**
+ * Builds a segment tree from the path of every route and walks the URL once to find candidate routes.
+ * Only candidates are validated with regex, in the order they were mapped, so the first mapped route still wins.
+ * Segments containing a single regular token, or a single `<token>` with a named constraint, are validated without regex,
+ * while other `<token>` patterns or optional tokens cannot be resolved by the tree,
+ * and will fall back to a regex match for any URL that reaches them.
+ *
+ * @package Titon\Route\Matcher
+ */
+class TrieMatcher extends AbstractIndexMatcher<TrieIndex> {
+
+    /**
+     * Return the name of the constraint that validates a token part without regex, or an empty string if it has none.
+     * Regular tokens use the built-in constraint for their kind of token, while `<token>` parts use their named
+     * constraint, unless a regex pattern takes precedence. Optional tokens are never resolved by a constraint.
+     *
+     * @param \Titon\Route\Route $route
+     * @param \Titon\Route\PathPart $part
+     * @return string
+     */
+    public static function getConstraint(Route $route, PathPart $part): string {
+        if ($part['type'] !== 'token' || $part['optional']) {
+            return '';
+        }
+
+        switch ($part['pattern']) {
+            case Route::ALNUM: return '{}';
+            case Route::NUMERIC: return '[]';
+            case Route::WILDCARD: return '()';
+        }
+
+        $token = $part['value'];
+
+        if ($route->getPatterns()->contains($token)) {
+            return '';
+        }
+
+        return (string) $route->getConstraints()->get($token);
+    }
+
+    /**
+     * Return true if every token in a segment is validated by a constraint, in which case the segment
+     * can never match across a slash, and can be resolved as a single URL segment.
+     *
+     * @param \Titon\Route\Route $route
+     * @param \Titon\Route\PathPartList $segment
+     * @return bool
+     */
+    public static function isSegment(Route $route, PathPartList $segment): bool {
+        foreach ($segment as $part) {
+            if ($part['type'] !== 'literal' && static::getConstraint($route, $part) === '') {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Split a URL into a list of segments, lowercased if case is folded, while removing a single trailing slash.
+     * Will return null if the URL is not an absolute path, as no route could match it.
+     *
+     * @param string $url
+     * @param bool $fold
+     * @return Vector<string>
+     */
+    public static function segment(string $url, bool $fold = true): ?Vector<string> {
+        if ($url === '' || $url === '/') {
+            return Vector {};
+        }
+
+        if ($url[0] !== '/') {
+            return null;
+        }
+
+        if (substr($url, -1) === '/') {
+            $url = substr($url, 0, -1);
+        }
+
+        $url = substr($url, 1);
+
+        return new Vector(explode('/', $fold ? strtolower($url) : $url));
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    protected function buildIndex(RouteMap $routes): TrieIndex {
+        $root = new TrieNode();
+        $fold = $this->foldsCase($routes);
+        $exact = Map {};
+        $keys = Vector {};
+        $list = Vector {};
+
+        foreach ($routes as $key => $route) {
+            $position = $list->count();
+            $keys[] = $key;
+            $list[] = $route;
+
+            $node = $root;
+
+            // Normalized routes expect a lowercased URL, so their literals are lowercased like the URL
+            $lower = ($fold || $route->getCasePolicy() === Router::CASE_NORMALIZE);
+            $terminated = true;
+
+            // A route is resolved exactly by the trie if every segment is a literal or a constrained token,
+            // and literals are compared with the same case sensitivity as the route regex
+            $resolved = $fold ? ($route->getCasePolicy() === Router::CASE_INSENSITIVE) : true;
+            $tokens = Vector {};
+
+            foreach ($route->getSegments() as $segment) {
+                $first = $segment[0];
+
+                if ($segment->count() === 1 && $first['type'] === 'literal') {
+                    $node = $node->literal($lower ? strtolower($first['value']) : $first['value']);
+                    $tokens[] = false;
+
+                // Constrained and regular tokens can be validated without regex
+                } else if ($segment->count() === 1 && ($constraint = static::getConstraint($route, $first)) !== '') {
+                    $node = $node->constrained($constraint);
+                    $tokens[] = true;
+
+                // Constrained and regular tokens mixed with literals can never match across a slash,
+                // so can be resolved as a single segment
+                } else if (static::isSegment($route, $segment)) {
+                    $node = $node->dynamic();
+                    $resolved = false;
+
+                } else {
+                    $node->addFallback($position);
+                    $terminated = false;
+                    break;
+                }
+            }
+
+            if ($terminated) {
+                $node->addRoute($position);
+
+                if ($resolved) {
+                    $exact[$key] = $tokens;
+                }
+            }
+        }
+
+        return shape(
+            'exact' => $exact,
+            'fold' => $fold,
+            'keys' => $keys,
+            'root' => $root,
+            'routes' => $list
+        );
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    protected function getCandidates(string $url, RouteMap $routes): KeyedIterator<string, Route> {
+        $index = $this->getIndex($routes);
+        $segments = static::segment($url, $index['fold']);
+
+        if ($segments === null) {
+            return;
+        }
+
+        $candidates = $index['root']->find($segments, 0, Set {})->toValuesArray();
+
+        sort($candidates);
+
+        foreach ($candidates as $position) {
+            yield $index['keys'][$position] => $index['routes'][$position];
+        }
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    protected function matchCandidate(string $url, RouteMap $routes, string $key, Route $route, RequestContext $context): ?MatchResult {
+        $exact = $this->getIndex($routes)['exact'];
+
+        if (!$exact->contains($key)) {
+            return $route->matchPath($url, $context, $key);
+        }
+
+        // Every segment was compared or validated while walking the trie, so the path regex can be skipped
+        $segments = static::segment($url, false) ?: Vector {};
+        $values = [];
+
+        foreach ($exact[$key] as $i => $token) {
+            if ($token) {
+                $values[] = $segments[$i];
+            }
+        }
+
+        return $route->matchResolved($url, $context, $key, $values);
+    }
+
+}
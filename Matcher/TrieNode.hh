@@ -0,0 +1,156 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Matcher;
+
+use Titon\Route\Constraint;
+
+/**
+ * A single node within the segment tree built by the `TrieMatcher`.
+ * Each node represents a path segment and stores the position of routes that terminate at,
+ * or can only be resolved by regex beyond, the node.
+ *
+ * @package Titon\Route\Matcher
+ */
+class TrieNode {
+
+    /**
+     * Child nodes keyed by the name of the constraint a segment must pass.
+     *
+     * @var Map<string, \Titon\Route\Matcher\TrieNode>
+     */
+    protected Map<string, TrieNode> $constrained = Map {};
+
+    /**
+     * Child node that matches any single segment.
+     *
+     * @var \Titon\Route\Matcher\TrieNode
+     */
+    protected ?TrieNode $dynamic;
+
+    /**
+     * Routes that match any URL reaching this node, and must be resolved with regex.
+     *
+     * @var Vector<int>
+     */
+    protected Vector<int> $fallback = Vector {};
+
+    /**
+     * Routes whose path terminates at this node.
+     *
+     * @var Vector<int>
+     */
+    protected Vector<int> $routes = Vector {};
+
+    /**
+     * Child nodes keyed by a literal segment, which is lowercased when the index folds case.
+     *
+     * @var Map<string, \Titon\Route\Matcher\TrieNode>
+     */
+    protected Map<string, TrieNode> $static = Map {};
+
+    /**
+     * Add a route that must be resolved with regex once this node is reached.
+     *
+     * @param int $position
+     * @return $this
+     */
+    public function addFallback(int $position): this {
+        $this->fallback[] = $position;
+
+        return $this;
+    }
+
+    /**
+     * Add a route that terminates at this node.
+     *
+     * @param int $position
+     * @return $this
+     */
+    public function addRoute(int $position): this {
+        $this->routes[] = $position;
+
+        return $this;
+    }
+
+    /**
+     * Return the child node that matches any segment passing a constraint, creating it if it does not exist.
+     *
+     * @param string $constraint
+     * @return \Titon\Route\Matcher\TrieNode
+     */
+    public function constrained(string $constraint): TrieNode {
+        if (!$this->constrained->contains($constraint)) {
+            $this->constrained[$constraint] = new TrieNode();
+        }
+
+        return $this->constrained[$constraint];
+    }
+
+    /**
+     * Return the child node that matches any segment, creating it if it does not exist.
+     *
+     * @return \Titon\Route\Matcher\TrieNode
+     */
+    public function dynamic(): TrieNode {
+        if ($this->dynamic === null) {
+            $this->dynamic = new TrieNode();
+        }
+
+        return $this->dynamic;
+    }
+
+    /**
+     * Walk the list of URL segments starting at this node, and collect the position of every route
+     * that could potentially match.
+     *
+     * @param Vector<string> $segments
+     * @param int $depth
+     * @param Set<int> $candidates
+     * @return Set<int>
+     */
+    public function find(Vector<string> $segments, int $depth, Set<int> $candidates): Set<int> {
+        $candidates->addAll($this->fallback);
+
+        if ($depth === $segments->count()) {
+            return $candidates->addAll($this->routes);
+        }
+
+        $segment = $segments[$depth];
+
+        if ($this->static->contains($segment)) {
+            $this->static[$segment]->find($segments, $depth + 1, $candidates);
+        }
+
+        if ($this->dynamic !== null && $segment !== '') {
+            $this->dynamic->find($segments, $depth + 1, $candidates);
+        }
+
+        foreach ($this->constrained as $constraint => $child) {
+            if ($segment !== '' && Constraint::validate($constraint, $segment)) {
+                $child->find($segments, $depth + 1, $candidates);
+            }
+        }
+
+        return $candidates;
+    }
+
+    /**
+     * Return the child node for a literal segment, creating it if it does not exist.
+     *
+     * @param string $segment
+     * @return \Titon\Route\Matcher\TrieNode
+     */
+    public function literal(string $segment): TrieNode {
+        if (!$this->static->contains($segment)) {
+            $this->static[$segment] = new TrieNode();
+        }
+
+        return $this->static[$segment];
+    }
+
+}
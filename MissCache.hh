@@ -0,0 +1,60 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+/**
+ * The MissCache stores requests that previously failed to match any route, so that repeated misses
+ * can be rejected without running the matcher. Entries are bounded and evicted in least recently used order.
+ * Should be flushed whenever the route table changes.
+ *
+ * @package Titon\Route
+ */
+class MissCache extends LruCache<bool> {
+
+    /**
+     * Set the entry limit.
+     *
+     * @param int $limit
+     */
+    public function __construct(int $limit = 10000) {
+        parent::__construct($limit);
+    }
+
+    /**
+     * Store a miss, evicting the least recently used miss if the limit has been reached.
+     *
+     * @param string $key
+     * @return $this
+     */
+    public function add(string $key): this {
+        return $this->set($key, true);
+    }
+
+    /**
+     * Return true if the request is a known miss, and mark it as the most recently used.
+     *
+     * @param string $key
+     * @return bool
+     */
+    public function has(string $key): bool {
+        return ($this->get($key) !== null);
+    }
+
+    /**
+     * Generate a cache key for a request. The URL is lowercased when routes are matched case-insensitively.
+     *
+     * @param \Titon\Route\RequestContext $context
+     * @param string $url
+     * @param bool $fold
+     * @return string
+     */
+    public static function key(RequestContext $context, string $url, bool $fold = true): string {
+        return MatchCache::key($context, $fold ? strtolower($url) : $url);
+    }
+
+}
@@ -7,6 +7,8 @@
 
 namespace Titon\Route\Mixin;
 
+use Titon\Route\Rule;
+
 /**
  * Provides functionality for conditionals.
  *
@@ -14,6 +16,13 @@ namespace Titon\Route\Mixin;
  */
 trait ConditionMixin {
 
+    /**
+     * List of asynchronous conditions to validate against.
+     *
+     * @var \Titon\Route\Mixin\AsyncConditionList
+     */
+    protected AsyncConditionList $asyncConditions = Vector {};
+
     /**
      * List of conditions to validate against.
      *
@@ -22,7 +31,41 @@ trait ConditionMixin {
     protected ConditionList $conditions = Vector {};
 
     /**
-     * Add a condition callback.
+     * List of declarative rules to validate against.
+     *
+     * @var \Titon\Route\Mixin\RuleList
+     */
+    protected RuleList $rules = Vector {};
+
+    /**
+     * Add an asynchronous condition callback. The callback must return an awaitable boolean.
+     *
+     * @param \Titon\Route\Mixin\AsyncConditionCallback $condition
+     * @return $this
+     */
+    public function addAsyncCondition(AsyncConditionCallback $condition): this {
+        $this->asyncConditions[] = $condition;
+
+        return $this;
+    }
+
+    /**
+     * Add multiple asynchronous conditions.
+     *
+     * @param \Titon\Route\Mixin\AsyncConditionList $conditions
+     * @return $this
+     */
+    public function addAsyncConditions(AsyncConditionList $conditions): this {
+        foreach ($conditions as $condition) {
+            $this->addAsyncCondition($condition);
+        }
+
+        return $this;
+    }
+
+    /**
+     * Add a condition callback. When matched through the router, conditions are memoized per request and route,
+     * so a condition is evaluated at most once for each route it is added to.
      *
      * @param \Titon\Route\Mixin\ConditionCallback $condition
      * @return $this
@@ -47,6 +90,41 @@ trait ConditionMixin {
         return $this;
     }
 
+    /**
+     * Add a declarative rule.
+     *
+     * @param \Titon\Route\Rule $rule
+     * @return $this
+     */
+    public function addRule(Rule $rule): this {
+        $this->rules[] = $rule;
+
+        return $this;
+    }
+
+    /**
+     * Add multiple declarative rules.
+     *
+     * @param \Titon\Route\Mixin\RuleList $rules
+     * @return $this
+     */
+    public function addRules(RuleList $rules): this {
+        foreach ($rules as $rule) {
+            $this->addRule($rule);
+        }
+
+        return $this;
+    }
+
+    /**
+     * Return the list of asynchronous conditions.
+     *
+     * @return \Titon\Route\Mixin\AsyncConditionList
+     */
+    public function getAsyncConditions(): AsyncConditionList {
+        return $this->asyncConditions;
+    }
+
     /**
      * Return the list of conditions.
      *
@@ -56,6 +134,36 @@ trait ConditionMixin {
         return $this->conditions;
     }
 
+    /**
+     * Return the list of declarative rules.
+     *
+     * @return \Titon\Route\Mixin\RuleList
+     */
+    public function getRules(): RuleList {
+        return $this->rules;
+    }
+
+    /**
+     * Return true if any conditions or rules have been defined.
+     *
+     * @return bool
+     */
+    public function hasConditions(): bool {
+        return ($this->conditions->count() > 0 || $this->asyncConditions->count() > 0 || $this->rules->count() > 0);
+    }
+
+    /**
+     * Set the list of asynchronous conditions to validate.
+     *
+     * @param \Titon\Route\Mixin\AsyncConditionList $conditions
+     * @return $this
+     */
+    public function setAsyncConditions(AsyncConditionList $conditions): this {
+        $this->asyncConditions = $conditions;
+
+        return $this;
+    }
+
     /**
      * Set the list of conditions to validate.
      *
@@ -68,4 +176,16 @@ trait ConditionMixin {
         return $this;
     }
 
+    /**
+     * Set the list of declarative rules to validate.
+     *
+     * @param \Titon\Route\Mixin\RuleList $rules
+     * @return $this
+     */
+    public function setRules(RuleList $rules): this {
+        $this->rules = $rules;
+
+        return $this;
+    }
+
 }
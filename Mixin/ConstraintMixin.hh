@@ -0,0 +1,72 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Mixin;
+
+/**
+ * Provides functionality for named token constraints.
+ *
+ * @package Titon\Route\Mixin
+ */
+trait ConstraintMixin {
+
+    /**
+     * Constraint names keyed by token name.
+     *
+     * @var \Titon\Route\Mixin\ConstraintMap
+     */
+    protected ConstraintMap $constraints = Map {};
+
+    /**
+     * Add a named constraint by token name.
+     *
+     * @param string $token
+     * @param string $constraint
+     * @return $this
+     */
+    public function addConstraint(string $token, string $constraint): this {
+        $this->constraints[$token] = $constraint;
+
+        return $this;
+    }
+
+    /**
+     * Add multiple named constraints.
+     *
+     * @param \Titon\Route\Mixin\ConstraintMap $constraints
+     * @return $this
+     */
+    public function addConstraints(ConstraintMap $constraints): this {
+        foreach ($constraints as $token => $constraint) {
+            $this->addConstraint($token, $constraint);
+        }
+
+        return $this;
+    }
+
+    /**
+     * Return all the named constraints used for compiling.
+     *
+     * @return \Titon\Route\Mixin\ConstraintMap
+     */
+    public function getConstraints(): ConstraintMap {
+        return $this->constraints;
+    }
+
+    /**
+     * Set a mapping of named constraints to parse URLs with.
+     *
+     * @param \Titon\Route\Mixin\ConstraintMap $constraints
+     * @return $this
+     */
+    public function setConstraints(ConstraintMap $constraints): this {
+        $this->constraints = $constraints;
+
+        return $this;
+    }
+
+}
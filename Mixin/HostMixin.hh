@@ -0,0 +1,45 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Mixin;
+
+/**
+ * Provides functionality for host names.
+ *
+ * @package Titon\Route\Mixin
+ */
+trait HostMixin {
+
+    /**
+     * The tokenized host name to match against (defaults to all).
+     *
+     * @var string
+     */
+    protected string $host = '';
+
+    /**
+     * Return the host.
+     *
+     * @return string
+     */
+    public function getHost(): string {
+        return $this->host;
+    }
+
+    /**
+     * Set the tokenized host name, for example `{account}.example.com`.
+     *
+     * @param string $host
+     * @return $this
+     */
+    public function setHost(string $host): this {
+        $this->host = $host;
+
+        return $this;
+    }
+
+}
@@ -7,6 +7,8 @@
 
 namespace Titon\Route\Mixin;
 
+use Titon\Route\PatternPool;
+
 /**
  * Provides functionality for regex patterns.
  *
@@ -22,14 +24,14 @@ trait PatternMixin {
     protected PatternMap $patterns = Map {};
 
     /**
-     * Add a regex pattern by token name.
+     * Add a regex pattern by token name. The pattern is interned, as the same patterns are usually shared by many routes.
      *
      * @param string $pattern
      * @param string $regex
      * @return $this
      */
     public function addPattern(string $pattern, string $regex): this {
-        $this->patterns[$pattern] = $regex;
+        $this->patterns[$pattern] = PatternPool::intern($regex);
 
         return $this;
     }
@@ -64,7 +66,7 @@ trait PatternMixin {
      * @return $this
      */
     public function setPatterns(PatternMap $patterns): this {
-        $this->patterns = $patterns;
+        $this->patterns = $patterns->map($regex ==> PatternPool::intern($regex));
 
         return $this;
     }
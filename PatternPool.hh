@@ -0,0 +1,140 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+/**
+ * The PatternPool interns the regex fragments and compiled regexes of routes, keyed by content, so that the
+ * many routes sharing the same patterns, or compiling to the same regex, like the routes generated by a resource
+ * for different methods, hold a single copy instead of their own.
+ * The pool is process-global, so it is bounded; once full, strings are returned without being pooled.
+ *
+ * @package Titon\Route
+ */
+class PatternPool {
+
+    /**
+     * Maximum amount of strings to pool.
+     *
+     * @var int
+     */
+    protected static int $limit = 1000;
+
+    /**
+     * Amount of interned strings that were already pooled.
+     *
+     * @var int
+     */
+    protected static int $hits = 0;
+
+    /**
+     * Amount of interned strings that were added to the pool.
+     *
+     * @var int
+     */
+    protected static int $misses = 0;
+
+    /**
+     * Pooled strings keyed by their content.
+     *
+     * @var Map<string, string>
+     */
+    protected static Map<string, string> $pool = Map {};
+
+    /**
+     * Return the amount of pooled strings.
+     *
+     * @return int
+     */
+    public static function count(): int {
+        return static::$pool->count();
+    }
+
+    /**
+     * Remove all pooled strings and reset the statistics.
+     * Routes that have already been compiled will keep their own reference.
+     */
+    public static function flush(): void {
+        static::$pool->clear();
+        static::$hits = 0;
+        static::$misses = 0;
+    }
+
+    /**
+     * Return the amount of interned strings that were already pooled.
+     *
+     * @return int
+     */
+    public static function getHits(): int {
+        return static::$hits;
+    }
+
+    /**
+     * Return the maximum amount of strings to pool.
+     *
+     * @return int
+     */
+    public static function getLimit(): int {
+        return static::$limit;
+    }
+
+    /**
+     * Return the amount of interned strings that were not already pooled.
+     *
+     * @return int
+     */
+    public static function getMisses(): int {
+        return static::$misses;
+    }
+
+    /**
+     * Return the total byte size of all pooled strings.
+     *
+     * @return int
+     */
+    public static function getSize(): int {
+        $size = 0;
+
+        foreach (static::$pool as $value) {
+            $size += strlen($value);
+        }
+
+        return $size;
+    }
+
+    /**
+     * Return the pooled copy of a string, adding it to the pool if it does not exist and the pool is not full.
+     *
+     * @param string $value
+     * @return string
+     */
+    public static function intern(string $value): string {
+        if (static::$pool->contains($value)) {
+            static::$hits++;
+
+            return static::$pool[$value];
+        }
+
+        static::$misses++;
+
+        if (static::$pool->count() >= static::$limit) {
+            return $value;
+        }
+
+        return static::$pool[$value] = $value;
+    }
+
+    /**
+     * Set the maximum amount of strings to pool. Strings that are already pooled are kept.
+     *
+     * @param int $limit
+     */
+    public static function setLimit(int $limit): void {
+        static::$limit = max(0, $limit);
+    }
+
+}
@@ -0,0 +1,338 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+use Titon\Route\Mixin\AsyncConditionCallback;
+use Titon\Route\Mixin\ConditionCallback;
+use Titon\Utility\State\Get;
+use Titon\Utility\State\Server;
+
+/**
+ * The RequestContext captures the parts of a request that routes are matched against,
+ * so that they are normalized once per match instead of once per route. A context can also be built manually
+ * to match requests that did not originate from the current process, like queued jobs or replayed logs.
+ *
+ * @package Titon\Route
+ */
+class RequestContext {
+
+    /**
+     * Pending or completed results of asynchronous conditions, keyed by condition and route identity.
+     *
+     * @var Map<string, Awaitable<bool>>
+     */
+    protected Map<string, Awaitable<bool>> $asyncConditions = Map {};
+
+    /**
+     * Results of conditions that have been evaluated against this request, keyed by condition and route identity.
+     *
+     * @var Map<string, bool>
+     */
+    protected Map<string, bool> $conditions = Map {};
+
+    /**
+     * Amount of conditions that have been evaluated.
+     *
+     * @var int
+     */
+    protected int $evaluations = 0;
+
+    /**
+     * Request headers keyed by lowercased and dashed name.
+     *
+     * @var Map<string, string>
+     */
+    protected Map<string, string> $headers;
+
+    /**
+     * Lowercased host name without a port.
+     *
+     * @var string
+     */
+    protected string $host;
+
+    /**
+     * Lowercased HTTP method.
+     *
+     * @var string
+     */
+    protected string $method;
+
+    /**
+     * The port the request was made on.
+     *
+     * @var int
+     */
+    protected int $port;
+
+    /**
+     * Query params of the request.
+     *
+     * @var Map<string, mixed>
+     */
+    protected Map<string, mixed> $query;
+
+    /**
+     * Results of rules that have been evaluated against this request, keyed by rule key.
+     *
+     * @var Map<string, bool>
+     */
+    protected Map<string, bool> $rules = Map {};
+
+    /**
+     * Amount of condition evaluations that were resolved from a previous result.
+     *
+     * @var int
+     */
+    protected int $savedEvaluations = 0;
+
+    /**
+     * Was the request made over a secure connection.
+     *
+     * @var bool
+     */
+    protected bool $secure;
+
+    /**
+     * Store and normalize the request settings.
+     *
+     * @param string $method
+     * @param string $host
+     * @param bool $secure
+     * @param int $port
+     * @param Map<string, string> $headers
+     * @param Map<string, mixed> $query
+     */
+    public function __construct(string $method = 'get', string $host = '', bool $secure = false, int $port = 80, Map<string, string> $headers = Map {}, Map<string, mixed> $query = Map {}) {
+        $this->method = strtolower($method);
+        $this->host = strtolower(preg_replace('/:\d+$/', '', $host));
+        $this->secure = $secure;
+        $this->port = $port;
+        $this->query = $query;
+        $this->headers = Map {};
+
+        foreach ($headers as $name => $value) {
+            $this->headers[static::normalizeHeader($name)] = $value;
+        }
+    }
+
+    /**
+     * Create a context from the server globals of the current request.
+     *
+     * @return \Titon\Route\RequestContext
+     */
+    public static function createFromGlobals(): RequestContext {
+        $headers = Map {};
+
+        foreach (Server::all() as $key => $value) {
+            if (substr($key, 0, 5) === 'HTTP_') {
+                $headers[substr($key, 5)] = (string) $value;
+            }
+        }
+
+        foreach (['CONTENT_TYPE', 'CONTENT_LENGTH'] as $key) {
+            if (($value = Server::get($key)) !== null) {
+                $headers[$key] = (string) $value;
+            }
+        }
+
+        return new RequestContext(
+            (string) Server::get('REQUEST_METHOD'),
+            (string) Server::get('HTTP_HOST'),
+            (Server::get('HTTPS') === 'on' || Server::get('SERVER_PORT') === '443'),
+            (int) Server::get('SERVER_PORT'),
+            $headers,
+            new Map(Get::all())
+        );
+    }
+
+    /**
+     * Evaluate a condition for a route. The result is stored by the identity of the condition and the route,
+     * as conditions are given the route, so that a route validated more than once, like when a cached match
+     * is re-validated, only evaluates each of its conditions once per request.
+     *
+     * @param \Titon\Route\Mixin\ConditionCallback $condition
+     * @param \Titon\Route\Route $route
+     * @return bool
+     */
+    public function evaluate(ConditionCallback $condition, Route $route): bool {
+        $key = static::identify($condition, $route);
+
+        if ($this->conditions->contains($key)) {
+            $this->savedEvaluations++;
+
+            return $this->conditions[$key];
+        }
+
+        $this->evaluations++;
+
+        return $this->conditions[$key] = (bool) call_user_func($condition, $route);
+    }
+
+    /**
+     * Evaluate an asynchronous condition for a route. The awaitable is stored by the identity of the condition
+     * and the route, so that concurrent validations of the same route await the same evaluation.
+     *
+     * @param \Titon\Route\Mixin\AsyncConditionCallback $condition
+     * @param \Titon\Route\Route $route
+     * @return Awaitable<bool>
+     */
+    public function genEvaluate(AsyncConditionCallback $condition, Route $route): Awaitable<bool> {
+        $key = static::identify($condition, $route);
+
+        if ($this->asyncConditions->contains($key)) {
+            $this->savedEvaluations++;
+
+            return $this->asyncConditions[$key];
+        }
+
+        $this->evaluations++;
+
+        return $this->asyncConditions[$key] = $condition($route);
+    }
+
+    /**
+     * Return the amount of conditions that have been evaluated.
+     *
+     * @return int
+     */
+    public function getEvaluations(): int {
+        return $this->evaluations;
+    }
+
+    /**
+     * Return a header by name, or null if it does not exist.
+     *
+     * @param string $name
+     * @return string
+     */
+    public function getHeader(string $name): ?string {
+        return $this->headers->get(static::normalizeHeader($name));
+    }
+
+    /**
+     * Return all headers.
+     *
+     * @return Map<string, string>
+     */
+    public function getHeaders(): Map<string, string> {
+        return $this->headers->toMap();
+    }
+
+    /**
+     * Return the host name.
+     *
+     * @return string
+     */
+    public function getHost(): string {
+        return $this->host;
+    }
+
+    /**
+     * Return the HTTP method.
+     *
+     * @return string
+     */
+    public function getMethod(): string {
+        return $this->method;
+    }
+
+    /**
+     * Return the port.
+     *
+     * @return int
+     */
+    public function getPort(): int {
+        return $this->port;
+    }
+
+    /**
+     * Return all query params.
+     *
+     * @return Map<string, mixed>
+     */
+    public function getQuery(): Map<string, mixed> {
+        return $this->query->toMap();
+    }
+
+    /**
+     * Return the amount of condition evaluations that were resolved from a previous result.
+     *
+     * @return int
+     */
+    public function getSavedEvaluations(): int {
+        return $this->savedEvaluations;
+    }
+
+    /**
+     * Return the scheme.
+     *
+     * @return string
+     */
+    public function getScheme(): string {
+        return $this->isSecure() ? 'https' : 'http';
+    }
+
+    /**
+     * Return true if a query param exists.
+     *
+     * @param string $name
+     * @return bool
+     */
+    public function hasQuery(string $name): bool {
+        return $this->query->contains($name);
+    }
+
+    /**
+     * Return true if the request was made over a secure connection.
+     *
+     * @return bool
+     */
+    public function isSecure(): bool {
+        return $this->secure;
+    }
+
+    /**
+     * Normalize a header name, so that `Content-Type`, `content_type`, and `CONTENT_TYPE` are equal.
+     *
+     * @param string $name
+     * @return string
+     */
+    public static function normalizeHeader(string $name): string {
+        return str_replace('_', '-', strtolower($name));
+    }
+
+    /**
+     * Evaluate a rule against the request and return true if it passes.
+     * The result is stored by rule key, so that each distinct rule is only evaluated once per request.
+     *
+     * @param \Titon\Route\Rule $rule
+     * @return bool
+     */
+    public function passes(Rule $rule): bool {
+        $key = $rule->getKey();
+
+        if (!$this->rules->contains($key)) {
+            $this->rules[$key] = $rule->evaluate($this);
+        }
+
+        return $this->rules[$key];
+    }
+
+    /**
+     * Return the key that a condition result is stored by for a route.
+     *
+     * @param mixed $condition
+     * @param \Titon\Route\Route $route
+     * @return string
+     */
+    protected static function identify(mixed $condition, Route $route): string {
+        return CallbackRegistry::identify($condition) . '|' . spl_object_hash($route);
+    }
+
+}
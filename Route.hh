@@ -8,13 +8,13 @@
 namespace Titon\Route;
 
 use Titon\Route\Exception\MissingPatternException;
-use Titon\Route\Exception\NoMatchException;
 use Titon\Route\Mixin\ConditionMixin;
+use Titon\Route\Mixin\ConstraintMixin;
 use Titon\Route\Mixin\FilterMixin;
+use Titon\Route\Mixin\HostMixin;
 use Titon\Route\Mixin\MethodMixin;
 use Titon\Route\Mixin\PatternMixin;
 use Titon\Route\Mixin\SecureMixin;
-use Titon\Utility\State\Server;
 use Titon\Utility\Registry;
 use \ReflectionFunctionAbstract;
 use \ReflectionMethod;
@@ -27,16 +27,17 @@ use \Serializable;
  * @package Titon\Route
  */
 class Route implements Serializable {
-    use ConditionMixin, FilterMixin, MethodMixin, PatternMixin, SecureMixin;
+    use ConditionMixin, ConstraintMixin, FilterMixin, HostMixin, MethodMixin, PatternMixin, SecureMixin;
 
     /**
      * Pre-defined regex patterns.
      */
-    const string ALPHA = '([a-z\_\-\.]+)';
-    const string ALNUM = '([a-z0-9\_\-\.]+)';
+    const string ALPHA = '([a-zA-Z\_\-\.]+)';
+    const string ALNUM = '([a-zA-Z0-9\_\-\.]+)';
     const string NUMERIC = '([0-9\.]+)';
     const string WILDCARD = '([^\/]+)';
-    const string LOCALE = '([a-z]{2}(?:-[a-z]{2})?)';
+    const string LOCALE = '([a-zA-Z]{2}(?:-[a-zA-Z]{2})?)';
+    const string SUBDOMAIN = '([a-zA-Z0-9\-]+)';
 
     /**
      * The action to execute if this route is matched.
@@ -45,6 +46,13 @@ class Route implements Serializable {
      */
     protected Action $action;
 
+    /**
+     * How the casing of a URL is treated when matching.
+     *
+     * @var string
+     */
+    protected string $casePolicy = Router::CASE_INSENSITIVE;
+
     /**
      * The compiled regex pattern.
      *
@@ -53,11 +61,32 @@ class Route implements Serializable {
     protected string $compiled = '';
 
     /**
-     * Collection of route parameters.
+     * The compiled host regex pattern.
+     *
+     * @var string
+     */
+    protected string $compiledHost = '';
+
+    /**
+     * The anchored host regex, built from the compiled host pattern.
      *
-     * @var \Titon\Route\ParamMap
+     * @var string
      */
-    protected ParamMap $params = Map {};
+    protected string $hostRegex = '';
+
+    /**
+     * Custom defined tokens within the host.
+     *
+     * @var Vector<string>
+     */
+    protected Vector<string> $hostTokens = Vector {};
+
+    /**
+     * The literal and token parts of the path, in the order they appear.
+     *
+     * @var \Titon\Route\PathPartList
+     */
+    protected PathPartList $parts = Vector {};
 
     /**
      * The path to match.
@@ -66,6 +95,13 @@ class Route implements Serializable {
      */
     protected string $path = '';
 
+    /**
+     * The anchored regex, built from the compiled path pattern.
+     *
+     * @var string
+     */
+    protected string $regex = '';
+
     /**
      * A static route that contains no patterns.
      *
@@ -80,13 +116,6 @@ class Route implements Serializable {
      */
     protected TokenList $tokens = Vector {};
 
-    /**
-     * The corresponding URL when a match is found.
-     *
-     * @var string
-     */
-    protected string $url = '';
-
     /**
      * Store the tokenized URL to match and the action to route to.
      *
@@ -113,10 +142,14 @@ class Route implements Serializable {
     }
 
     /**
-     * Compile the given path into a detectable regex pattern.
+     * Compile the given path into a detectable regex pattern. The path is lexed in a single pass into a list of
+     * literal and token parts, which is stored on the route alongside the anchored regex so that it can be re-used.
+     * Compilation does not modify the path, patterns, or static flag, so the definition of a route is the same
+     * whether or not it has been compiled.
      *
      * @return string
      * @throws \Titon\Route\Exception\MissingPatternException
+     * @throws \Titon\Route\Exception\MissingConstraintException
      */
     public function compile(): string {
         if ($this->isCompiled()) {
@@ -124,71 +157,90 @@ class Route implements Serializable {
         }
 
         $path = $this->getPath();
-        $compiled = str_replace(['/', '.'], ['\/', '\.'], $path);
-        $patterns = $this->getPatterns();
-
-        if (!$this->isStatic()) {
-            $tokens = [];
+        $compiled = '';
+        $parts = Vector {};
+        $normalize = ($this->getCasePolicy() === Router::CASE_NORMALIZE);
+
+        if ($this->isStatic()) {
+            $parts[] = shape('type' => 'literal', 'value' => $path, 'pattern' => '', 'optional' => false);
+            $compiled = str_replace(['/', '.'], ['\/', '\.'], $normalize ? strtolower($path) : $path);
+
+        } else {
+            // Inline patterns only apply to this compilation, so copy the patterns instead of modifying the definition
+            $patterns = $this->getPatterns()->toMap();
+            $constraints = $this->getConstraints();
             $matches = [];
+            $offset = 0;
 
-            // Match regex pattern tokens first
-            preg_match_all('/(\<)([^\<\>]+)(\>)/i', $path, $matches, PREG_SET_ORDER);
-            $tokens = array_merge($tokens, $matches);
+            preg_match_all('/\<[^\<\>]+\>|[\{\(\[][a-z0-9\?]+[\}\)\]]/i', $path, $matches, PREG_SET_ORDER | PREG_OFFSET_CAPTURE);
 
-            // Then match regular tokens
-            preg_match_all('/(\{|\(|\[)([a-z0-9\?]+)(\}|\)|\])/i', $path, $matches, PREG_SET_ORDER);
-            $tokens = array_merge($tokens, $matches);
+            foreach ($matches as $match) {
+                list($chunk, $position) = $match[0];
 
-            if ($tokens) {
-                foreach ($tokens as $match) {
-                    $chunk = $match[0];
-                    $open = array_key_exists(1, $match) ? $match[1] : ''; // opening brace
-                    $token = array_key_exists(2, $match) ? $match[2] : ''; // token
-                    $close = array_key_exists(3, $match) ? $match[3] : ''; // closing brace
-                    $optional = false;
+                // Literal text in between tokens
+                if ($position > $offset) {
+                    $literal = substr($path, $offset, $position - $offset);
+                    $parts[] = shape('type' => 'literal', 'value' => $literal, 'pattern' => '', 'optional' => false);
+                    $compiled .= str_replace(['/', '.'], ['\/', '\.'], $normalize ? strtolower($literal) : $literal);
+                }
 
-                    // Is the token optional
-                    if (substr($token, -1) === '?') {
-                        $optional = true;
-                        $token = substr($token, 0, strlen($token) - 1);
-                    }
+                $offset = $position + strlen($chunk);
+                $open = substr($chunk, 0, 1);
+                $close = substr($chunk, -1);
+                $token = substr($chunk, 1, -1);
+                $optional = false;
 
-                    // Pattern exists
-                    if (strpos($token, ':') !== false) {
-                        list($token, $pattern) = explode(':', $token, 2);
+                // Is the token optional
+                if (substr($token, -1) === '?') {
+                    $optional = true;
+                    $token = substr($token, 0, -1);
+                }
 
-                        $patterns[$token] = $pattern;
-                        $this->addPattern($token, $pattern);
-                    }
+                // Pattern exists
+                if (strpos($token, ':') !== false) {
+                    list($token, $pattern) = explode(':', $token, 2);
 
-                    if ($open === '{' && $close === '}') {
-                        $pattern = self::ALNUM;
+                    $patterns[$token] = $pattern;
+                }
 
-                    } else if ($open === '[' && $close === ']') {
-                        $pattern = self::NUMERIC;
+                if ($open === '{' && $close === '}') {
+                    $pattern = self::ALNUM;
 
-                    } else if ($open === '(' && $close === ')') {
-                        $pattern = self::WILDCARD;
+                } else if ($open === '[' && $close === ']') {
+                    $pattern = self::NUMERIC;
 
-                    } else if ($open === '<' && $close === '>' && $patterns->contains($token)) {
-                        $pattern = '(' . trim($patterns[$token], '()') . ')';
+                } else if ($open === '(' && $close === ')') {
+                    $pattern = self::WILDCARD;
 
-                    } else {
-                        throw new MissingPatternException(sprintf('Unknown pattern for %s token', $token));
-                    }
+                } else if ($open === '<' && $close === '>' && $patterns->contains($token)) {
+                    $pattern = '(' . trim($patterns[$token], '()') . ')';
 
-                    // Apply optional flag by altering chunk and pattern
-                    if ($optional) {
-                        $chunk = '\/' . $chunk;
-                        $pattern = '(?:\/' . $pattern . ')?';
-                    }
+                } else if ($open === '<' && $close === '>' && $constraints->contains($token)) {
+                    $pattern = '(' . trim(Constraint::getPattern($constraints[$token]), '()') . ')';
 
-                    $compiled = str_replace($chunk, $pattern, $compiled);
+                } else {
+                    throw new MissingPatternException(sprintf('Unknown pattern for %s token', $token));
+                }
 
-                    $this->tokens[] = shape('token' => $token, 'optional' => $optional);
+                // Apply optional flag by consuming the preceding slash into the pattern
+                if ($optional && substr($compiled, -2) === '\/') {
+                    $compiled = substr($compiled, 0, -2);
+                    $pattern = '(?:\/' . $pattern . ')?';
                 }
-            } else {
-                $this->setStatic(true);
+
+                $pattern = PatternPool::intern($pattern);
+                $compiled .= $pattern;
+
+                $parts[] = shape('type' => 'token', 'value' => $token, 'pattern' => $pattern, 'optional' => $optional);
+
+                $this->tokens[] = shape('token' => $token, 'optional' => $optional);
+            }
+
+            // Literal text after the last token
+            if ($offset < strlen($path)) {
+                $literal = substr($path, $offset);
+                $parts[] = shape('type' => 'literal', 'value' => $literal, 'pattern' => '', 'optional' => false);
+                $compiled .= str_replace(['/', '.'], ['\/', '\.'], $normalize ? strtolower($literal) : $literal);
             }
         }
 
@@ -197,29 +249,117 @@ class Route implements Serializable {
             $compiled .= '\/?';
         }
 
+        $this->parts = $parts;
+        $this->regex = PatternPool::intern('~^' . $compiled . '$~' . $this->getRegexModifiers());
+
         // Save the compiled regex
-        return $this->compiled = $compiled;
+        return $this->compiled = PatternPool::intern($compiled);
+    }
+
+    /**
+     * Compile the host into a detectable regex pattern. Host tokens are written as `{token}`,
+     * which match a single sub-domain, or as `<token>`, which match a custom pattern.
+     * Will return an empty string if no host has been defined.
+     *
+     * @return string
+     * @throws \Titon\Route\Exception\MissingPatternException
+     */
+    public function compileHost(): string {
+        $host = $this->getHost();
+
+        if ($host === '' || $this->compiledHost !== '') {
+            return $this->compiledHost;
+        }
+
+        $patterns = $this->getPatterns();
+        $compiled = '';
+
+        foreach (preg_split('/(\{[a-z0-9]+\}|\<[a-z0-9]+\>)/i', $host, -1, PREG_SPLIT_DELIM_CAPTURE) as $part) {
+            $open = substr($part, 0, 1);
+            $token = substr($part, 1, -1);
+
+            if ($open === '{') {
+                $compiled .= self::SUBDOMAIN;
+
+            } else if ($open === '<') {
+                if (!$patterns->contains($token)) {
+                    throw new MissingPatternException(sprintf('Unknown pattern for %s host token', $token));
+                }
+
+                $compiled .= '(' . trim($patterns[$token], '()') . ')';
+
+            } else {
+                $compiled .= preg_quote($part, '~');
+                continue;
+            }
+
+            $this->hostTokens[] = $token;
+        }
+
+        return $this->compiledHost = PatternPool::intern($compiled);
     }
 
     /**
-     * Dispatch the current route to the defined action only if the route has been matched.
+     * Dispatch the route to the defined action using the params of a match result.
      * The dispatcher will use the params gathered from the token list to pass as arguments to the action.
      * Arguments will take into account default values defined on the method.
      *
+     * @param \Titon\Route\MatchResult $result
      * @return mixed - The response of the action call
-     * @exception \Titon\Route\Exception\NoMatchException
      */
-    public function dispatch(): mixed {
-        if (!$this->isMatched()) {
-            throw new NoMatchException('Route cannot be dispatched unless it has been matched');
-        }
-
+    public function dispatch(MatchResult $result): mixed {
         $action = $this->getAction();
         $object = Registry::factory($action['class'], []);
 
         $method = new ReflectionMethod($object, $action['action']);
 
-        return $method->invokeArgs($object, $this->getActionArguments());
+        return $method->invokeArgs($object, $this->getActionArguments($result->getParams()));
+    }
+
+    /**
+     * Attempt to match the URL against the route asynchronously, while awaiting all asynchronous conditions.
+     *
+     * @param string $url
+     * @param \Titon\Route\RequestContext $context
+     * @param string $key
+     * @return Awaitable<\Titon\Route\MatchResult>
+     */
+    public async function genMatch(string $url, RequestContext $context, string $key = ''): Awaitable<?MatchResult> {
+        $result = $this->matchPath($url, $context, $key);
+
+        if ($result === null) {
+            return null;
+        }
+
+        $valid = await $this->genValid($context);
+
+        return $valid ? $result : null;
+    }
+
+    /**
+     * Validate the route is matchable by running through all synchronous conditions first,
+     * and then awaiting all asynchronous conditions concurrently.
+     * If a request context is defined, conditions are memoized for the request by their identity.
+     *
+     * @param \Titon\Route\RequestContext $context
+     * @return Awaitable<bool>
+     */
+    public async function genValid(?RequestContext $context = null): Awaitable<bool> {
+        foreach ($this->getConditions() as $condition) {
+            if (!($context ? $context->evaluate($condition, $this) : call_user_func($condition, $this))) {
+                return false;
+            }
+        }
+
+        $results = await \HH\Asio\v($this->getAsyncConditions()->map($condition ==> $context ? $context->genEvaluate($condition, $this) : $condition($this)));
+
+        foreach ($results as $result) {
+            if (!$result) {
+                return false;
+            }
+        }
+
+        return true;
     }
 
     /**
@@ -234,13 +374,34 @@ class Route implements Serializable {
     /**
      * Return the type casted arguments for the defined action method.
      *
+     * @param ImmMap<string, mixed> $params
      * @return \Titon\Route\ArgumentList
      */
-    public function getActionArguments(): ArgumentList {
+    public function getActionArguments(ImmMap<string, mixed> $params): ArgumentList {
         $action = $this->getAction();
         $method = new ReflectionMethod($action['class'], $action['action']);
 
-        return $this->getArguments($method);
+        return $this->getArguments($method, $params);
+    }
+
+    /**
+     * Return how the casing of a URL is treated when matching.
+     *
+     * @return string
+     */
+    public function getCasePolicy(): string {
+        return $this->casePolicy;
+    }
+
+    /**
+     * Return the literal and token parts of the path, compiling the path if it has not been compiled.
+     *
+     * @return \Titon\Route\PathPartList
+     */
+    public function getParts(): PathPartList {
+        $this->compile();
+
+        return $this->parts;
     }
 
     /**
@@ -253,22 +414,76 @@ class Route implements Serializable {
     }
 
     /**
-     * Return a param from the matched route.
+     * Return the anchored regex used to match a host name. Will return an empty string if no host has been defined.
      *
-     * @param string $key
-     * @return mixed
+     * @return string
+     */
+    public function getHostRegex(): string {
+        if ($this->hostRegex === '' && $this->getHost() !== '') {
+            $this->hostRegex = PatternPool::intern('~^' . $this->compileHost() . '$~i');
+        }
+
+        return $this->hostRegex;
+    }
+
+    /**
+     * Return the compiled host tokens.
+     *
+     * @return Vector<string>
+     */
+    public function getHostTokens(): Vector<string> {
+        return $this->hostTokens;
+    }
+
+    /**
+     * Return the anchored regex used to match a URL, compiling the path if it has not been compiled.
+     *
+     * @return string
      */
-    public function getParam(string $key): mixed {
-        return $this->getParams()->get($key);
+    public function getRegex(): string {
+        if ($this->regex === '') {
+            $this->regex = PatternPool::intern('~^' . $this->compile() . '$~' . $this->getRegexModifiers());
+        }
+
+        return $this->regex;
     }
 
     /**
-     * Return all params.
+     * Return the parts of the path grouped by segment, compiling the path if it has not been compiled.
+     * Literal parts are split on slashes, so that each segment only contains the parts in between two slashes,
+     * which allows segment based matchers to index a route without parsing its path again.
      *
-     * @return \Titon\Route\ParamMap
+     * @return \Titon\Route\PathSegmentList
      */
-    public function getParams(): ParamMap {
-        return $this->params;
+    public function getSegments(): PathSegmentList {
+        $segments = Vector {};
+        $segment = Vector {};
+
+        foreach ($this->getParts() as $part) {
+            if ($part['type'] !== 'literal') {
+                $segment[] = $part;
+                continue;
+            }
+
+            foreach (explode('/', $part['value']) as $i => $value) {
+                // Empty segments, like in `/a//b`, are kept as an empty literal
+                if ($i > 0) {
+                    $segments[] = $segment ?: Vector {shape('type' => 'literal', 'value' => '', 'pattern' => '', 'optional' => false)};
+                    $segment = Vector {};
+                }
+
+                if ($value !== '') {
+                    $segment[] = shape('type' => 'literal', 'value' => $value, 'pattern' => '', 'optional' => false);
+                }
+            }
+        }
+
+        if ($segment) {
+            $segments[] = $segment;
+        }
+
+        // Paths always start with a slash, so the first segment is always empty
+        return $segments->skip(1);
     }
 
     /**
@@ -289,6 +504,27 @@ class Route implements Serializable {
         return $this->tokens;
     }
 
+    /**
+     * Return true if the route can be cached, which requires every condition to be registered in the callback registry.
+     *
+     * @return bool
+     */
+    public function isCacheable(): bool {
+        foreach ($this->getConditions() as $condition) {
+            if (CallbackRegistry::getName($condition) === null) {
+                return false;
+            }
+        }
+
+        foreach ($this->getAsyncConditions() as $condition) {
+            if (CallbackRegistry::getName($condition) === null) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     /**
      * Has the regex pattern been compiled?
      *
@@ -299,72 +535,70 @@ class Route implements Serializable {
     }
 
     /**
-     * Does the URL match the current route?
+     * Validates the route matches the requested host name.
      *
-     * @param string $url
+     * @param \Titon\Route\RequestContext $context
      * @return bool
      */
-    public function isMatch(string $url): bool {
-        $matches = [];
-
-        // Compile the regex pattern
-        $this->compile();
-
-        // Match the route based on a set of conditions
-        if (!$this->isMethod()) {
-            return false;
-
-        } else if (!$this->isSecure()) {
-            return false;
-
-        } else if (!$this->isValid()) {
-            return false;
-
-        } else if ($this->getPath() === $url) {
-            $this->url = $url;
-
-            return true;
-
-        } else if (preg_match('~^' . $this->compile() . '$~i', $url, $matches)) {
-            $this->match($matches);
-
-            return true;
+    public function isHost(RequestContext $context): bool {
+        if ($this->getHost() === '') {
+            return true; // Only validate if a host is defined
         }
 
-        return false;
+        return (bool) preg_match($this->getHostRegex(), $context->getHost());
     }
 
     /**
-     * Return true if the route has been matched.
+     * Does the URL match the current route?
      *
+     * @param string $url
+     * @param \Titon\Route\RequestContext $context
      * @return bool
      */
-    public function isMatched(): bool {
-        return (bool) $this->url();
+    public function isMatch(string $url, ?RequestContext $context = null): bool {
+        return ($this->match($url, $context ?: RequestContext::createFromGlobals()) !== null);
     }
 
     /**
      * Validates the route matches the correct HTTP method.
      *
+     * @param \Titon\Route\RequestContext $context
      * @return bool
      */
-    public function isMethod(): bool {
+    public function isMethod(RequestContext $context): bool {
         $methods = $this->getMethods();
 
-        if ($methods && !in_array(strtolower(Server::get('REQUEST_METHOD')), $methods, true)) {
+        if ($methods && !in_array($context->getMethod(), $methods, true)) {
             return false;
         }
 
         return true;
     }
 
+    /**
+     * Validates the request satisfies all declarative rules. Each distinct rule is evaluated once per request context.
+     *
+     * @param \Titon\Route\RequestContext $context
+     * @return bool
+     */
+    public function isSatisfied(RequestContext $context): bool {
+        foreach ($this->getRules() as $rule) {
+            if (!$context->passes($rule)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     /**
      * Validates the route matches a secure connection.
      *
+     * @param \Titon\Route\RequestContext $context
      * @return bool
      */
-    public function isSecure(): bool {
-        if ($this->getSecure() && !(Server::get('HTTPS') === 'on' || Server::get('SERVER_PORT') === '443')) {
+    public function isSecure(RequestContext $context): bool {
+        if ($this->getSecure() && !$context->isSecure()) {
             return false; // Only validate if the secure flag is true
         }
 
@@ -372,22 +606,29 @@ class Route implements Serializable {
     }
 
     /**
-     * Is the route static (no regex patterns)?
+     * Is the route static (no regex patterns)? A compiled route without tokens is always static.
      *
      * @return bool
      */
     public function isStatic(): bool {
-        return (bool) $this->getStatic();
+        return ($this->getStatic() || ($this->isCompiled() && !$this->tokens));
     }
 
     /**
      * Validate the route is matchable by running through all defined conditions.
+     * Asynchronous conditions are joined, so prefer `genValid()` when running in an async context.
+     * If a request context is defined, conditions are memoized for the request by their identity.
      *
+     * @param \Titon\Route\RequestContext $context
      * @return bool
      */
-    public function isValid(): bool {
+    public function isValid(?RequestContext $context = null): bool {
+        if ($this->getAsyncConditions()) {
+            return \HH\Asio\join($this->genValid($context));
+        }
+
         foreach ($this->getConditions() as $condition) {
-            if (!call_user_func($condition, $this)) {
+            if (!($context ? $context->evaluate($condition, $this) : call_user_func($condition, $this))) {
                 return false;
             }
         }
@@ -396,24 +637,50 @@ class Route implements Serializable {
     }
 
     /**
-     * Receive a list of matched values and apply it to the current route.
-     * These matches will equate to tokens, arguments, and other required values.
+     * Attempt to match the URL against the route, and return a match result containing the params
+     * gathered from the path and host tokens. Will return null if the route does not match.
+     * The route itself is never modified, so it can be safely shared between requests.
      *
-     * @param array<string> $matches
-     * @return $this
+     * @param string $url
+     * @param \Titon\Route\RequestContext $context
+     * @param string $key
+     * @return \Titon\Route\MatchResult
      */
-    public function match(array<string> $matches): this {
-        $tokens = $this->getTokens();
-
-        $this->url = array_shift($matches);
+    public function match(string $url, RequestContext $context, string $key = ''): ?MatchResult {
+        $result = $this->matchPath($url, $context, $key);
 
-        if ($matches && $tokens) {
-            foreach ($tokens as $token) {
-                $this->params[$token['token']] = array_shift($matches);
-            }
+        if ($result === null || !$this->isValid($context)) {
+            return null;
         }
 
-        return $this;
+        return $result;
+    }
+
+    /**
+     * Attempt to match the URL against the route without validating conditions.
+     * Conditions are evaluated separately so that they can be awaited concurrently across routes.
+     *
+     * @param string $url
+     * @param \Titon\Route\RequestContext $context
+     * @param string $key
+     * @return \Titon\Route\MatchResult
+     */
+    public function matchPath(string $url, RequestContext $context, string $key = ''): ?MatchResult {
+        return $this->resolveMatch($url, $context, $key, null);
+    }
+
+    /**
+     * Attempt to match the URL against the route without validating conditions, nor evaluating the path regex,
+     * as the path has already been resolved by a matcher. The values of all path tokens must be defined in order.
+     *
+     * @param string $url
+     * @param \Titon\Route\RequestContext $context
+     * @param string $key
+     * @param array<string> $values
+     * @return \Titon\Route\MatchResult
+     */
+    public function matchResolved(string $url, RequestContext $context, string $key, array<string> $values): ?MatchResult {
+        return $this->resolveMatch($url, $context, $key, $values);
     }
 
     /**
@@ -428,16 +695,44 @@ class Route implements Serializable {
         return $this;
     }
 
+    /**
+     * Restore the compiled state of a route that was loaded from a cache, so that it is not compiled again.
+     *
+     * @param string $compiled
+     * @param string $regex
+     * @param \Titon\Route\TokenList $tokens
+     * @param \Titon\Route\PathPartList $parts
+     * @return $this
+     */
+    public function restore(string $compiled, string $regex, TokenList $tokens, PathPartList $parts): this {
+        $this->compiled = PatternPool::intern($compiled);
+        $this->regex = PatternPool::intern($regex);
+        $this->tokens = $tokens;
+        $this->parts = $parts;
+
+        return $this;
+    }
+
     /**
      * Serialize the compiled route for increasing performance when caching mapped routes.
+     * The route must be cacheable, as unregistered callbacks and conditions can not be restored.
      */
     public function serialize(): string {
+        invariant($this->isCacheable(), 'Route has callbacks or conditions that are not registered.');
+
         return serialize(Map {
             'action' => $this->getAction(),
+            'asyncConditions' => $this->getAsyncConditions()->map($condition ==> (string) CallbackRegistry::getName($condition)),
+            'casePolicy' => $this->getCasePolicy(),
             'compiled' => $this->compile(),
+            'conditions' => $this->getConditions()->map($condition ==> (string) CallbackRegistry::getName($condition)),
+            'constraints' => $this->getConstraints(),
             'filters' => $this->getFilters(),
+            'host' => $this->getHost(),
             'methods' => $this->getMethods(),
+            'parts' => $this->getParts(),
             'patterns' => $this->getPatterns(),
+            'rules' => $this->getRules(),
             'path' => $this->getPath(),
             'secure' => $this->getSecure(),
             'static' => $this->getStatic(),
@@ -457,6 +752,46 @@ class Route implements Serializable {
         return $this;
     }
 
+    /**
+     * Set how the casing of a URL is treated when matching. Insensitive will match with a case-insensitive regex,
+     * sensitive will match bytes exactly, while normalize expects the URL to be lowercased before matching.
+     * Changing the policy will reset the compiled path, as the regex depends on it.
+     *
+     * @param string $policy
+     * @return $this
+     */
+    public function setCasePolicy(string $policy): this {
+        invariant(in_array($policy, [Router::CASE_INSENSITIVE, Router::CASE_NORMALIZE, Router::CASE_SENSITIVE], true), 'Unknown case policy.');
+
+        if ($policy !== $this->casePolicy) {
+            $this->casePolicy = $policy;
+            $this->compiled = '';
+            $this->regex = '';
+            $this->parts = Vector {};
+            $this->tokens = Vector {};
+        }
+
+        return $this;
+    }
+
+    /**
+     * Set the tokenized host name, for example `{account}.example.com`.
+     * Changing the host will reset the compiled host, as the host regex and tokens depend on it.
+     *
+     * @param string $host
+     * @return $this
+     */
+    public function setHost(string $host): this {
+        if ($host !== $this->host) {
+            $this->host = $host;
+            $this->compiledHost = '';
+            $this->hostRegex = '';
+            $this->hostTokens = Vector {};
+        }
+
+        return $this;
+    }
+
     /**
      * Set the static flag.
      *
@@ -479,23 +814,27 @@ class Route implements Serializable {
 
         $this->path = $data['path'];
         $this->action = $data['action'];
+        $this->casePolicy = $data['casePolicy'];
         $this->tokens = $data['tokens'];
-        $this->compiled = $data['compiled'];
+        $this->compiled = PatternPool::intern($data['compiled']);
+        $this->parts = $data['parts'];
 
+        $this->setConstraints($data['constraints']);
         $this->setFilters($data['filters']);
+        $this->setHost($data['host']);
         $this->setMethods($data['methods']);
         $this->setPatterns($data['patterns']);
+        $this->setRules($data['rules']);
         $this->setSecure($data['secure']);
         $this->setStatic($data['static']);
-    }
 
-    /**
-     * Return the currently matched full URL.
-     *
-     * @return string
-     */
-    public function url(): string {
-        return $this->url;
+        foreach ($data['conditions'] as $condition) {
+            $this->addCondition(CallbackRegistry::getCondition($condition));
+        }
+
+        foreach ($data['asyncConditions'] as $condition) {
+            $this->addAsyncCondition(CallbackRegistry::getAsyncCondition($condition));
+        }
     }
 
     /**
@@ -503,11 +842,12 @@ class Route implements Serializable {
      * Furthermore, loop through and set any default values using reflection, and type cast appropriately.
      *
      * @param \ReflectionFunctionAbstract $method
+     * @param ImmMap<string, mixed> $params
      * @return \Titon\Route\ArgumentList
      */
-    protected function getArguments(ReflectionFunctionAbstract $method): ArgumentList {
+    protected function getArguments(ReflectionFunctionAbstract $method, ImmMap<string, mixed> $params): ArgumentList {
         $tokens = $this->getTokens();
-        $args = $this->getParams()->values()->toArray();
+        $args = $params->values()->toArray();
 
         foreach ($method->getParameters() as $i => $param) {
             if (!$tokens->containsKey($i)) {
@@ -529,4 +869,70 @@ class Route implements Serializable {
         return $args;
     }
 
+    /**
+     * Return the modifiers to apply to the anchored regex based on the case policy.
+     *
+     * @return string
+     */
+    protected function getRegexModifiers(): string {
+        return ($this->getCasePolicy() === Router::CASE_INSENSITIVE) ? 'i' : '';
+    }
+
+    /**
+     * Match the request against the route, and gather params from the path and host tokens.
+     * If path token values are not defined, the path is matched with the route regex.
+     *
+     * @param string $url
+     * @param \Titon\Route\RequestContext $context
+     * @param string $key
+     * @param array<string> $values
+     * @return \Titon\Route\MatchResult
+     */
+    protected function resolveMatch(string $url, RequestContext $context, string $key, ?array<string> $values): ?MatchResult {
+        $matches = [];
+        $hostMatches = [];
+        $params = Map {};
+
+        // Compile the regex pattern
+        $this->compile();
+
+        // Match the route based on a set of conditions
+        if (!$this->isMethod($context)) {
+            return null;
+
+        } else if (!$this->isSecure($context)) {
+            return null;
+
+        } else if ($this->getHost() !== '' && !preg_match($this->getHostRegex(), $context->getHost(), $hostMatches)) {
+            return null;
+
+        } else if (!$this->isSatisfied($context)) {
+            return null;
+
+        } else if ($values === null && $this->getPath() !== $url && !preg_match($this->getRegex(), $url, $matches)) {
+            return null;
+        }
+
+        // Apply path params in the order of the tokens
+        if ($values === null) {
+            array_shift($matches);
+            $values = $matches;
+        }
+
+        if ($values) {
+            foreach ($this->getTokens() as $token) {
+                $params[$token['token']] = array_shift($values);
+            }
+        }
+
+        // Apply host params after path params so that they do not offset action arguments
+        array_shift($hostMatches);
+
+        foreach ($this->getHostTokens() as $token) {
+            $params[$token] = array_shift($hostMatches);
+        }
+
+        return new MatchResult($key, $this, $url, $params->toImmMap());
+    }
+
 }
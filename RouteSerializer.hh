@@ -0,0 +1,453 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+use \ReflectionClass;
+
+/**
+ * The RouteSerializer encodes the route table into a compact and versioned format for caching.
+ * Every string is stored once in a string table and referenced by integer id, HTTP methods are stored as a bitmask,
+ * and compiled patterns are stored so that routes do not need to be compiled again. Dispatch callbacks and conditions
+ * are stored by the name they were registered with in the `CallbackRegistry`, and are resolved when hydrating.
+ * The payload only contains flat arrays of scalars, so it can be decoded in a single pass,
+ * without unserializing a nested graph of collections, and it can optionally be compressed.
+ *
+ * A table can also be split into shards by the first segment of each route path, along with an index
+ * that maps each route to its shard, so that a request only needs to decode the shards its URL can match.
+ *
+ * @package Titon\Route
+ */
+class RouteSerializer {
+
+    /**
+     * Prefix that identifies the format.
+     */
+    const string HEADER = 'titon.route';
+
+    /**
+     * The version of the format. Must be incremented whenever the layout of a row changes.
+     */
+    const int VERSION = 4;
+
+    /**
+     * Flags packed into a single integer per route.
+     */
+    const int FLAG_SECURE = 1;
+    const int FLAG_STATIC = 2;
+
+    /**
+     * Shard for routes whose first segment contains tokens, which can match any URL.
+     */
+    const string WILDCARD_SHARD = '*';
+
+    /**
+     * Bits for common HTTP methods. Other methods are stored by string id.
+     *
+     * @var Map<string, int>
+     */
+    protected static Map<string, int> $methodBits = Map {
+        'get' => 1,
+        'post' => 2,
+        'put' => 4,
+        'delete' => 8,
+        'patch' => 16,
+        'head' => 32,
+        'options' => 64
+    };
+
+    /**
+     * Should the payload be compressed.
+     *
+     * @var bool
+     */
+    protected bool $compress;
+
+    /**
+     * Set the compression setting.
+     *
+     * @param bool $compress
+     */
+    public function __construct(bool $compress = false) {
+        $this->compress = $compress;
+    }
+
+    /**
+     * Decode a payload into a route map. Will return null if the payload was encoded
+     * with a different version of the format, or if it could not be read, so that routes are mapped again.
+     *
+     * @param string $data
+     * @return \Titon\Route\RouteMap
+     */
+    public function decode(string $data): ?RouteMap {
+        $payload = $this->unpack($data, 'rz');
+
+        if ($payload === null) {
+            return null;
+        }
+
+        $data = $payload['data'];
+
+        if ($payload['format'] === 'z') {
+            $data = gzuncompress($data);
+
+            if ($data === false) {
+                return null;
+            }
+        }
+
+        $table = unserialize($data);
+
+        if (!is_array($table) || !array_key_exists('strings', $table) || !array_key_exists('routes', $table)) {
+            return null;
+        }
+
+        return $this->hydrate($table);
+    }
+
+    /**
+     * Decode an index payload into the fingerprint of the table and its shards keyed by route key.
+     * Will return null under the same conditions as `decode()`.
+     *
+     * @param string $data
+     * @return \Titon\Route\ShardIndex
+     */
+    public function decodeIndex(string $data): ?ShardIndex {
+        $payload = $this->unpack($data, 'i');
+
+        if ($payload === null) {
+            return null;
+        }
+
+        $index = unserialize($payload['data']);
+
+        if (!is_array($index) || !array_key_exists('fingerprint', $index) || !array_key_exists('shards', $index)) {
+            return null;
+        }
+
+        return shape(
+            'fingerprint' => (string) $index['fingerprint'],
+            'shards' => new Map($index['shards'])
+        );
+    }
+
+    /**
+     * Dehydrate routes into a table of unique strings and flat route rows. Routes are compiled before being dehydrated,
+     * and must be cacheable, as unregistered callbacks and conditions can not be restored.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @return array<string, mixed>
+     */
+    public function dehydrate(RouteMap $routes): array<string, mixed> {
+        $strings = Map {};
+        $rows = [];
+
+        // Return the id of a string, adding it to the string table if it does not exist
+        $id = (string $value) ==> {
+            if (!$strings->contains($value)) {
+                $strings[$value] = $strings->count();
+            }
+
+            return $strings[$value];
+        };
+
+        foreach ($routes as $key => $route) {
+            invariant($route->isCacheable(), 'Route %s has callbacks or conditions that are not registered.', $key);
+
+            $compiled = $route->compile();
+            $action = $route->getAction();
+            $mask = 0;
+            $methods = [];
+            $patterns = [];
+            $constraints = [];
+            $tokens = [];
+            $parts = [];
+            $rules = [];
+            $conditions = [];
+            $asyncConditions = [];
+            $callback = -1;
+
+            foreach ($route->getMethods() as $method) {
+                if (static::$methodBits->contains($method)) {
+                    $mask |= static::$methodBits[$method];
+                } else {
+                    $methods[] = $id($method);
+                }
+            }
+
+            foreach ($route->getPatterns() as $name => $pattern) {
+                $patterns[] = $id($name);
+                $patterns[] = $id($pattern);
+            }
+
+            foreach ($route->getConstraints() as $token => $constraint) {
+                $constraints[] = $id($token);
+                $constraints[] = $id($constraint);
+            }
+
+            foreach ($route->getTokens() as $token) {
+                $tokens[] = $id($token['token']);
+                $tokens[] = (int) $token['optional'];
+            }
+
+            foreach ($route->getParts() as $part) {
+                $parts[] = $id($part['type']);
+                $parts[] = $id($part['value']);
+                $parts[] = $id($part['pattern']);
+                $parts[] = (int) $part['optional'];
+            }
+
+            foreach ($route->getRules() as $rule) {
+                $rules[] = $id($rule->getType());
+                $rules[] = $id($rule->getName());
+                $rules[] = $id($rule->getValue());
+            }
+
+            foreach ($route->getConditions() as $condition) {
+                $conditions[] = $id((string) CallbackRegistry::getName($condition));
+            }
+
+            foreach ($route->getAsyncConditions() as $condition) {
+                $asyncConditions[] = $id((string) CallbackRegistry::getName($condition));
+            }
+
+            if ($route instanceof CallbackRoute) {
+                $callback = $id((string) CallbackRegistry::getName($route->getCallback()));
+            }
+
+            $rows[] = [
+                $id($key),
+                $id(get_class($route)),
+                $id($action['class']),
+                $id($action['action']),
+                $id($route->getPath()),
+                $id($route->getHost()),
+                $id($compiled),
+                $id($route->getRegex()),
+                $mask,
+                $methods,
+                ($route->getSecure() ? self::FLAG_SECURE : 0) | ($route->getStatic() ? self::FLAG_STATIC : 0),
+                $id($route->getCasePolicy()),
+                $route->getFilters()->map($filter ==> $id($filter))->toArray(),
+                $patterns,
+                $constraints,
+                $tokens,
+                $parts,
+                $rules,
+                $conditions,
+                $asyncConditions,
+                $callback
+            ];
+        }
+
+        return ['strings' => $strings->keys()->toArray(), 'routes' => $rows];
+    }
+
+    /**
+     * Encode a route map into the compact format.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @return string
+     */
+    public function encode(RouteMap $routes): string {
+        $payload = serialize($this->dehydrate($routes));
+        $format = 'r';
+
+        if ($this->isCompressed()) {
+            $payload = gzcompress($payload);
+            $format = 'z';
+        }
+
+        return implode('|', [self::HEADER, self::VERSION, $format, $payload]);
+    }
+
+    /**
+     * Encode an index of shards keyed by route key, as returned by `index()`, along with the fingerprint
+     * of the compiled table, so that the fingerprint is known without loading every shard.
+     *
+     * @param Map<string, string> $index
+     * @param string $fingerprint
+     * @return string
+     */
+    public function encodeIndex(Map<string, string> $index, string $fingerprint): string {
+        return implode('|', [self::HEADER, self::VERSION, 'i', serialize([
+            'fingerprint' => $fingerprint,
+            'shards' => $index->toArray()
+        ])]);
+    }
+
+    /**
+     * Return the shard for a URL, which is the lowercased first segment.
+     *
+     * @param string $url
+     * @return string
+     */
+    public static function getShard(string $url): string {
+        return '/' . strtolower(explode('/', ltrim($url, '/'), 2)[0]);
+    }
+
+    /**
+     * Hydrate routes from a table of strings and flat route rows, as returned by `dehydrate()`.
+     *
+     * @param array<string, mixed> $table
+     * @return \Titon\Route\RouteMap
+     * @throws \Titon\Route\Exception\MissingCallbackException
+     */
+    public function hydrate(array<string, mixed> $table): RouteMap {
+        $strings = $table['strings'];
+        $classes = Map {};
+        $routes = Map {};
+
+        foreach ($table['routes'] as $row) {
+            $class = $strings[$row[1]];
+
+            if (!$classes->contains($class)) {
+                $classes[$class] = new ReflectionClass($class);
+            }
+
+            $route = $classes[$class]->newInstanceWithoutConstructor();
+
+            invariant($route instanceof Route, 'Must be a Route.');
+
+            $methods = Vector {};
+
+            foreach (static::$methodBits as $method => $bit) {
+                if ($row[8] & $bit) {
+                    $methods[] = $method;
+                }
+            }
+
+            foreach ($row[9] as $id) {
+                $methods[] = $strings[$id];
+            }
+
+            $route
+                ->setCasePolicy($strings[$row[11]])
+                ->setAction(shape('class' => $strings[$row[2]], 'action' => $strings[$row[3]]))
+                ->append($strings[$row[4]])
+                ->setHost($strings[$row[5]])
+                ->setMethods($methods)
+                ->setSecure((bool) ($row[10] & self::FLAG_SECURE))
+                ->setStatic((bool) ($row[10] & self::FLAG_STATIC))
+                ->setFilters((new Vector($row[12]))->map($id ==> $strings[$id]))
+                ->setPatterns($this->decodeMap($row[13], $strings))
+                ->setConstraints($this->decodeMap($row[14], $strings));
+
+            $tokens = Vector {};
+
+            for ($i = 0; $i < count($row[15]); $i += 2) {
+                $tokens[] = shape('token' => $strings[$row[15][$i]], 'optional' => (bool) $row[15][$i + 1]);
+            }
+
+            $parts = Vector {};
+
+            for ($i = 0; $i < count($row[16]); $i += 4) {
+                $parts[] = shape(
+                    'type' => $strings[$row[16][$i]],
+                    'value' => $strings[$row[16][$i + 1]],
+                    'pattern' => $strings[$row[16][$i + 2]],
+                    'optional' => (bool) $row[16][$i + 3]
+                );
+            }
+
+            for ($i = 0; $i < count($row[17]); $i += 3) {
+                $route->addRule(new Rule($strings[$row[17][$i]], $strings[$row[17][$i + 1]], $strings[$row[17][$i + 2]]));
+            }
+
+            foreach ($row[18] as $id) {
+                $route->addCondition(CallbackRegistry::getCondition($strings[$id]));
+            }
+
+            foreach ($row[19] as $id) {
+                $route->addAsyncCondition(CallbackRegistry::getAsyncCondition($strings[$id]));
+            }
+
+            if ($route instanceof CallbackRoute) {
+                $route->setCallback(CallbackRegistry::get($strings[$row[20]]));
+            }
+
+            $routes[$strings[$row[0]]] = $route->restore($strings[$row[6]], $strings[$row[7]], $tokens, $parts);
+        }
+
+        return $routes;
+    }
+
+    /**
+     * Return the shard of every route, keyed by route key, in the order routes were mapped.
+     * A route is sharded by its lowercased first segment if it is a literal, otherwise it is in the wildcard shard.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @return Map<string, string>
+     */
+    public function index(RouteMap $routes): Map<string, string> {
+        $index = Map {};
+
+        foreach ($routes as $key => $route) {
+            $segment = $route->getSegments()->get(0);
+
+            if ($segment === null) {
+                $index[$key] = '/';
+
+            } else if ($segment->count() === 1 && $segment[0]['type'] === 'literal') {
+                $index[$key] = '/' . strtolower($segment[0]['value']);
+
+            } else {
+                $index[$key] = self::WILDCARD_SHARD;
+            }
+        }
+
+        return $index;
+    }
+
+    /**
+     * Return true if the payload is compressed.
+     *
+     * @return bool
+     */
+    public function isCompressed(): bool {
+        return $this->compress;
+    }
+
+    /**
+     * Decode a flat list of alternating key and value string ids into a map.
+     *
+     * @param array<int> $list
+     * @param array<string> $strings
+     * @return Map<string, string>
+     */
+    protected function decodeMap(array<int> $list, array<string> $strings): Map<string, string> {
+        $map = Map {};
+
+        for ($i = 0; $i < count($list); $i += 2) {
+            $map[$strings[$list[$i]]] = $strings[$list[$i + 1]];
+        }
+
+        return $map;
+    }
+
+    /**
+     * Validate the header of a payload and return its format and data.
+     * Will return null if the header is invalid, of a different version, or not one of the allowed formats.
+     *
+     * @param string $data
+     * @param string $formats
+     * @return shape('format' => string, 'data' => string)
+     */
+    protected function unpack(string $data, string $formats): ?shape('format' => string, 'data' => string) {
+        $header = explode('|', substr($data, 0, 32), 4);
+
+        if (count($header) !== 4 || $header[0] !== self::HEADER || (int) $header[1] !== self::VERSION || strlen($header[2]) !== 1 || strpos($formats, $header[2]) === false) {
+            return null;
+        }
+
+        return shape(
+            'format' => $header[2],
+            'data' => substr($data, strlen($header[0]) + strlen($header[1]) + 4)
+        );
+    }
+
+}
@@ -17,9 +17,14 @@ use Titon\Route\Annotation\Route as RouteAnnotation;
 use Titon\Route\Event\MatchedEvent;
 use Titon\Route\Event\MatchingEvent;
 use Titon\Route\Exception\InvalidRouteActionException;
+use Titon\Route\Exception\MissingCallbackException;
 use Titon\Route\Exception\MissingFilterException;
 use Titon\Route\Exception\MissingRouteException;
 use Titon\Route\Exception\NoMatchException;
+use Titon\Route\Exception\StaleMatcherException;
+use Titon\Route\Generator\GeneratedTable;
+use Titon\Route\Matcher\AbstractIndexMatcher;
+use Titon\Route\Matcher\GeneratedMatcher;
 use Titon\Route\Matcher\LoopMatcher;
 use Titon\Route\Mixin\MethodList;
 use Titon\Route\Group as RouteGroup; // Will fatal without alias
@@ -33,6 +38,41 @@ use Titon\Utility\Registry;
 class Router implements Subject {
     use EmitsEvents;
 
+    /**
+     * Case policies.
+     */
+    const string CASE_INSENSITIVE = 'insensitive';
+    const string CASE_NORMALIZE = 'normalize';
+    const string CASE_SENSITIVE = 'sensitive';
+
+    /**
+     * Storage key of the route table, scoped by the fingerprint of the mapped routes.
+     *
+     * @var string
+     */
+    protected string $cacheKey = '';
+
+    /**
+     * Amount of seconds a process holds the lease to build and cache the route table.
+     *
+     * @var int
+     */
+    protected int $cacheLease = 30;
+
+    /**
+     * Routes that have been loaded from cached shards, keyed by route key.
+     *
+     * @var \Titon\Route\RouteMap
+     */
+    protected RouteMap $cachedRoutes = Map {};
+
+    /**
+     * Fingerprint of the compiled route table, as stored with the index of the cached table.
+     *
+     * @var string
+     */
+    protected string $cachedFingerprint = '';
+
     /**
      * Have routes been loaded in from the cache?
      *
@@ -41,11 +81,25 @@ class Router implements Subject {
     protected bool $cached = false;
 
     /**
-     * The matched route object.
+     * How the casing of a URL is treated when matching.
+     *
+     * @var string
+     */
+    protected string $casePolicy = self::CASE_INSENSITIVE;
+
+    /**
+     * The request context of the last match.
      *
-     * @var \Titon\Route\Route
+     * @var \Titon\Route\RequestContext
      */
-    protected ?Route $current;
+    protected ?RequestContext $context;
+
+    /**
+     * The result of the last match.
+     *
+     * @var \Titon\Route\MatchResult
+     */
+    protected ?MatchResult $current;
 
     /**
      * List of filters to trigger for specific routes during a match.
@@ -61,6 +115,20 @@ class Router implements Subject {
      */
     protected GroupList $groups = Vector {};
 
+    /**
+     * In-memory cache of previous match results.
+     *
+     * @var \Titon\Route\MatchCache
+     */
+    protected ?MatchCache $matchCache;
+
+    /**
+     * In-memory cache of previous requests that did not match.
+     *
+     * @var \Titon\Route\MissCache
+     */
+    protected ?MissCache $missCache;
+
     /**
      * The class to use for route matching.
      *
@@ -68,6 +136,51 @@ class Router implements Subject {
      */
     protected Matcher $matcher;
 
+    /**
+     * Routes partitioned by the HTTP method they respond to.
+     * Routes without methods are placed in every partition, and in the empty partition.
+     *
+     * @var Map<string, \Titon\Route\RouteMap>
+     */
+    protected Map<string, RouteMap> $methodRoutes = Map {};
+
+    /**
+     * Host partition keys, keyed by HTTP method and host name.
+     * Host names are client provided, so keys are bounded and evicted in least recently used order.
+     *
+     * @var \Titon\Route\LruCache<string>
+     */
+    protected LruCache<string> $hostKeys;
+
+    /**
+     * Routes filtered by the host name they respond to, keyed by HTTP method and the host patterns that matched.
+     *
+     * @var Map<string, \Titon\Route\RouteMap>
+     */
+    protected Map<string, RouteMap> $hostRoutes = Map {};
+
+    /**
+     * Distinct rules of the routes in each host partition, keyed by host partition key, and then by rule key.
+     *
+     * @var Map<string, Map<string, \Titon\Route\Rule>>
+     */
+    protected Map<string, Map<string, Rule>> $hostRules = Map {};
+
+    /**
+     * Routes filtered by the rules they pass, keyed by host partition key, and the rules that failed.
+     * Rule outcomes depend on client provided values, so maps are bounded and evicted in least recently used order.
+     *
+     * @var \Titon\Route\LruCache<\Titon\Route\RouteMap>
+     */
+    protected LruCache<RouteMap> $ruleRoutes;
+
+    /**
+     * The amount of routes that existed when the method partitions were built.
+     *
+     * @var int
+     */
+    protected int $methodRoutesCount = 0;
+
     /**
      * Mapping of CRUD actions to URL path parts for REST resources.
      * These mappings will be used when creating resource() routes.
@@ -88,6 +201,21 @@ class Router implements Subject {
         'delete' => 'delete'
     };
 
+    /**
+     * Mapped routes that were replaced by the cached route table.
+     * Are used in place of a cached shard that could not be loaded.
+     *
+     * @var \Titon\Route\RouteMap
+     */
+    protected RouteMap $mappedRoutes = Map {};
+
+    /**
+     * Cached shards that have not been loaded yet.
+     *
+     * @var Set<string>
+     */
+    protected Set<string> $pendingShards = Set {};
+
     /**
      * Manually defined aesthetic routes that re-route internally.
      *
@@ -95,6 +223,20 @@ class Router implements Subject {
      */
     protected RouteMap $routes = Map {};
 
+    /**
+     * Serializer used to encode the route table into the storage engine.
+     *
+     * @var \Titon\Route\RouteSerializer
+     */
+    protected RouteSerializer $serializer;
+
+    /**
+     * The shard of every cached route, keyed by route key, in the order routes were mapped.
+     *
+     * @var Map<string, string>
+     */
+    protected Map<string, string> $shardIndex = Map {};
+
     /**
      * Storage engine instance.
      *
@@ -107,6 +249,9 @@ class Router implements Subject {
      */
     public function __construct() {
         $this->matcher = new LoopMatcher();
+        $this->serializer = new RouteSerializer();
+        $this->hostKeys = new LruCache(1000);
+        $this->ruleRoutes = new LruCache(100);
 
         // Set events
         $this->on('route.matching', inst_meth($this, 'doLoadRoutes'), 1);
@@ -125,11 +270,45 @@ class Router implements Subject {
     }
 
     /**
-     * Return the current matched route object.
+     * Compile the path and host of every mapped route up front, so that the cost is paid during boot instead of
+     * during the first requests, and so that invalid patterns are surfaced immediately.
+     * Will return the compile time of each route in milliseconds, keyed by route key.
      *
-     * @return \Titon\Route\Route
+     * @return Map<string, float>
+     * @throws \Titon\Route\Exception\MissingPatternException
+     */
+    public function compileAll(): Map<string, float> {
+        $this->loadRoutes();
+
+        $timings = Map {};
+
+        foreach ($this->getRoutes() as $key => $route) {
+            $start = microtime(true);
+
+            $route->getRegex();
+            $route->getHostRegex();
+
+            $timings[$key] = (microtime(true) - $start) * 1000;
+        }
+
+        return $timings;
+    }
+
+    /**
+     * Return the request context of the last match. Can be used to inspect how many condition evaluations were saved.
+     *
+     * @return \Titon\Route\RequestContext
+     */
+    public function context(): ?RequestContext {
+        return $this->context;
+    }
+
+    /**
+     * Return the result of the last match.
+     *
+     * @return \Titon\Route\MatchResult
      */
-    public function current(): ?Route {
+    public function current(): ?MatchResult {
         return $this->current;
     }
 
@@ -145,7 +324,9 @@ class Router implements Subject {
     }
 
     /**
-     * Cache the currently mapped routes.
+     * Cache the currently mapped routes. Routes are split into shards by the first segment of their path,
+     * which are stored individually, along with an index that maps each route to its shard.
+     * Routes that are not cacheable are left out of their shard, and the mapped route is used in their place.
      * This method is automatically called during the `matched` event.
      *
      * @param \Titon\Event\Event $event
@@ -161,13 +342,35 @@ class Router implements Subject {
         }
 
         if (($storage = $router->getStorage()) && ($routes = $router->getRoutes())) {
-            // Before caching, make sure all routes are compiled
-            foreach ($routes as $route) {
-                $route->compile();
+            // Only a single process builds the table, while other processes continue to match with their mapped routes
+            if (!$router->acquireCacheLease($storage)) {
+                return true;
+            }
+
+            // Routes are compiled while indexing, which should speed up the next request
+            $serializer = $router->getSerializer();
+            $index = $serializer->index($routes);
+            $shards = Map {};
+
+            foreach ($index as $key => $shard) {
+                // Unregistered callbacks and conditions can not be restored, so the mapped route is used instead
+                if (!$routes[$key]->isCacheable()) {
+                    continue;
+                }
+
+                if (!$shards->contains($shard)) {
+                    $shards[$shard] = Map {};
+                }
+
+                $shards[$shard][$key] = $routes[$key];
+            }
+
+            foreach ($shards as $shard => $shardRoutes) {
+                $storage->save(new Item($router->getCacheKey($shard), $serializer->encode($shardRoutes), '+1 year'));
             }
 
-            // Compiling before hand should speed up the next request
-            $storage->save(new Item('routes', serialize($routes), '+1 year'));
+            // Save the index last, so that a partially saved table is never loaded
+            $storage->save(new Item($router->getCacheKey(), $serializer->encodeIndex($index, $router->getFingerprint()), '+1 year'));
         }
 
         return true;
@@ -183,18 +386,18 @@ class Router implements Subject {
         invariant($event instanceof MatchedEvent, 'Must be a MatchedEvent.');
 
         $router = $event->getRouter();
-        $route = $event->getRoute();
+        $result = $event->getResult();
 
-        foreach ($route->getFilters() as $filter) {
+        foreach ($result->getRoute()->getFilters() as $filter) {
             $callback = $this->getFilter($filter);
-            $callback($router, $route);
+            $callback($router, $result);
         }
 
         return true;
     }
 
     /**
-     * Load routes from the cache if they exist.
+     * Load the cached routes that can match the URL, if they exist.
      * This method is automatically called during the `matching` event.
      *
      * @param \Titon\Event\Event $event
@@ -203,12 +406,7 @@ class Router implements Subject {
     public function doLoadRoutes(Event $event): mixed {
         invariant($event instanceof MatchingEvent, 'Must be a MatchingEvent.');
 
-        $item = $event->getRouter()->getStorage()?->getItem('routes');
-
-        if ($item !== null && $item->isHit()) {
-            $this->routes = unserialize($item->get());
-            $this->cached = true;
-        }
+        $event->getRouter()->loadRoutes($event->getUrl());
 
         return true;
     }
@@ -239,6 +437,32 @@ class Router implements Subject {
         return $this;
     }
 
+    /**
+     * Attempt to match an internal route asynchronously, and return the result of the match.
+     * Asynchronous conditions of candidate routes are awaited concurrently, while the first mapped route that matches wins.
+     * If no request context is defined, one will be created from the current request.
+     *
+     * @param string $url
+     * @param \Titon\Route\RequestContext $context
+     * @return Awaitable<\Titon\Route\MatchResult>
+     * @throws \Titon\Route\Exception\NoMatchException
+     */
+    public async function genMatch(string $url, ?RequestContext $context = null): Awaitable<MatchResult> {
+        $this->emit(new MatchingEvent($this, $url));
+
+        $url = $this->normalizeUrl($url);
+        $context = $context ?: RequestContext::createFromGlobals();
+        $routes = $this->getRoutesByContext($context);
+
+        if ($match = $this->loadMatch($url, $context, $routes)) {
+            return $this->finishMatch($url, $context, $match);
+        }
+
+        $match = await $this->getMatcher()->genMatch($url, $routes, $context);
+
+        return $this->finishMatch($url, $context, $this->saveMatch($url, $context, $match));
+    }
+
     /**
      * Map a route that only responds to a GET request.
      *
@@ -250,6 +474,60 @@ class Router implements Subject {
         return $this->http($key, Vector {'get'}, $route);
     }
 
+    /**
+     * Return the storage key of the route table. The key is scoped by a fingerprint of the routes as they were mapped,
+     * so that a changed route table is never loaded from a stale cache, and so that processes running different
+     * deploys can share a single storage engine. The fingerprint is determined before routes are compiled,
+     * as the cached routes are loaded in place of the mapped routes. If a shard is defined, the key of the shard is returned.
+     *
+     * @param string $shard
+     * @return string
+     */
+    public function getCacheKey(string $shard = ''): string {
+        if ($this->cacheKey === '') {
+            $this->cacheKey = 'routes.' . $this->hashRoutes($this->routes);
+        }
+
+        if ($shard !== '') {
+            return $this->cacheKey . '.' . md5($shard);
+        }
+
+        return $this->cacheKey;
+    }
+
+    /**
+     * Return the amount of seconds a process holds the lease to build and cache the route table.
+     *
+     * @return int
+     */
+    public function getCacheLease(): int {
+        return $this->cacheLease;
+    }
+
+    /**
+     * Return how the casing of a URL is treated when matching.
+     *
+     * @return string
+     */
+    public function getCasePolicy(): string {
+        return $this->casePolicy;
+    }
+
+    /**
+     * Return a fingerprint of all mapped routes and the settings that affect matching and dispatching.
+     *
+     * @return string
+     */
+    public function getFingerprint(): string {
+        // Use the fingerprint stored with a lazily loaded table, so that pending shards are not loaded
+        if ($this->pendingShards && $this->cachedFingerprint !== '') {
+            return $this->cachedFingerprint;
+        }
+
+        // Load any pending shards, so that every route is hashed
+        return $this->hashRoutes($this->getRoutes());
+    }
+
     /**
      * Return a filter by key.
      *
@@ -283,6 +561,15 @@ class Router implements Subject {
         return $this->groups;
     }
 
+    /**
+     * Return the match cache.
+     *
+     * @return \Titon\Route\MatchCache
+     */
+    public function getMatchCache(): ?MatchCache {
+        return $this->matchCache;
+    }
+
     /**
      * Return the matcher object.
      *
@@ -292,6 +579,15 @@ class Router implements Subject {
         return $this->matcher;
     }
 
+    /**
+     * Return the miss cache.
+     *
+     * @return \Titon\Route\MissCache
+     */
+    public function getMissCache(): ?MissCache {
+        return $this->missCache;
+    }
+
     /**
      * Return the CRUD action resource map.
      *
@@ -309,6 +605,10 @@ class Router implements Subject {
      * @throws \Titon\Route\Exception\MissingRouteException
      */
     public function getRoute(string $key): Route {
+        if (!$this->routes->contains($key) && $this->shardIndex->contains($key)) {
+            $this->loadShards([$this->shardIndex[$key]]);
+        }
+
         if ($this->routes->contains($key)) {
             return $this->routes[$key];
         }
@@ -322,9 +622,176 @@ class Router implements Subject {
      * @return \Titon\Route\RouteMap
      */
     public function getRoutes(): RouteMap {
+        if ($this->pendingShards) {
+            $this->loadShards($this->pendingShards->toArray());
+        }
+
         return $this->routes;
     }
 
+    /**
+     * Return all routes that can respond to the request context, in the order they were mapped.
+     * Routes are first filtered by method and host, and then by their declarative rules. Each distinct rule
+     * is evaluated once per request, and routes are bucketed by the rules that failed, so that requests
+     * with the same outcome share the same route map, and the matcher index built from it.
+     *
+     * @param \Titon\Route\RequestContext $context
+     * @return \Titon\Route\RouteMap
+     */
+    public function getRoutesByContext(RequestContext $context): RouteMap {
+        $routes = $this->getRoutesByHost($context->getMethod(), $context->getHost());
+        $cacheKey = $this->getHostKey($context->getMethod(), $context->getHost());
+        $failed = Set {};
+
+        foreach ($this->hostRules->get($cacheKey) ?: Map {} as $ruleKey => $rule) {
+            if (!$context->passes($rule)) {
+                $failed[] = $ruleKey;
+            }
+        }
+
+        // Every rule passed, so re-use the host partition
+        if (!$failed) {
+            return $routes;
+        }
+
+        $cacheKey .= '|' . md5(implode("\n", $failed));
+
+        if (($cached = $this->ruleRoutes->get($cacheKey)) !== null) {
+            return $cached;
+        }
+
+        $filtered = Map {};
+
+        foreach ($routes as $key => $route) {
+            foreach ($route->getRules() as $rule) {
+                if ($failed->contains($rule->getKey())) {
+                    continue 2;
+                }
+            }
+
+            $filtered[$key] = $route;
+        }
+
+        $this->ruleRoutes->set($cacheKey, $filtered);
+
+        return $filtered;
+    }
+
+    /**
+     * Return all routes that can respond to the defined HTTP method and host name, in the order they were mapped.
+     * Hosts that match the same host patterns share the same route map, and the matcher index built from it,
+     * so the amount of partitions is bounded by the mapped host patterns, not by the host names requested.
+     *
+     * @param string $method
+     * @param string $host
+     * @return \Titon\Route\RouteMap
+     */
+    public function getRoutesByHost(string $method, string $host): RouteMap {
+        $routes = $this->getRoutesByMethod($method);
+        $cacheKey = $this->getHostKey($method, $host);
+
+        if ($this->hostRoutes->contains($cacheKey)) {
+            return $this->hostRoutes[$cacheKey];
+        }
+
+        $hosts = Map {};
+        $rules = Map {};
+        $filtered = Map {};
+
+        foreach ($routes as $key => $route) {
+            $pattern = $route->getHost();
+
+            foreach ($route->getRules() as $rule) {
+                $rules[$rule->getKey()] = $rule;
+            }
+
+            if ($pattern === '') {
+                $filtered[$key] = $route;
+                continue;
+            }
+
+            if (!$hosts->contains($pattern)) {
+                $hosts[$pattern] = $this->matchesHost($route, $host);
+            }
+
+            if ($hosts[$pattern]) {
+                $filtered[$key] = $route;
+            }
+        }
+
+        // No routes are restricted by host, so re-use the method partition
+        if (!$hosts) {
+            $filtered = $routes;
+        }
+
+        $this->hostRules[$cacheKey] = $rules;
+
+        return $this->hostRoutes[$cacheKey] = $filtered;
+    }
+
+    /**
+     * Return all routes that can respond to the defined HTTP method, in the order they were mapped.
+     * The route table is partitioned by method the first time this is called, and again when routes are mapped.
+     *
+     * @param string $method
+     * @return \Titon\Route\RouteMap
+     * @throws \Titon\Route\Exception\StaleMatcherException
+     */
+    public function getRoutesByMethod(string $method): RouteMap {
+        // Only use the loaded shards, as the URL being matched has already loaded every shard it can match
+        $routes = $this->routes;
+        $partitions = $this->methodRoutes;
+        $method = strtolower($method);
+
+        // Rebuild the partitions if routes were modified outside of map()
+        if ($partitions && $this->methodRoutesCount !== $routes->count()) {
+            $partitions->clear();
+        }
+
+        if (!$partitions) {
+            // Validate the matcher before partitioning, so that a stale matcher is never used by later requests
+            $this->prepareMatcher();
+
+            $partitions[''] = Map {};
+            $this->hostKeys->flush();
+            $this->hostRoutes->clear();
+            $this->hostRules->clear();
+            $this->ruleRoutes->flush();
+
+            // Create all partitions first so that method-less routes are added in order
+            foreach ($routes as $route) {
+                foreach ($route->getMethods() as $routeMethod) {
+                    if (!$partitions->contains($routeMethod)) {
+                        $partitions[$routeMethod] = Map {};
+                    }
+                }
+            }
+
+            $this->methodRoutesCount = $routes->count();
+
+            foreach ($routes as $key => $route) {
+                $routeMethods = $route->getMethods();
+
+                foreach ($partitions as $partitionMethod => $partition) {
+                    if (!$routeMethods || in_array($partitionMethod, $routeMethods, true)) {
+                        $partition[$key] = $route;
+                    }
+                }
+            }
+        }
+
+        return $partitions->contains($method) ? $partitions[$method] : $partitions[''];
+    }
+
+    /**
+     * Return the route table serializer.
+     *
+     * @return \Titon\Route\RouteSerializer
+     */
+    public function getSerializer(): RouteSerializer {
+        return $this->serializer;
+    }
+
     /**
      * Get the storage engine.
      *
@@ -336,7 +803,7 @@ class Router implements Subject {
 
     /**
      * Group multiple route mappings into a single collection and apply options to all of them.
-     * Can apply path prefixes, suffixes, patterns, filters, methods, conditions, and more.
+     * Can apply hosts, path prefixes, suffixes, patterns, filters, methods, conditions, and more.
      *
      * @param \Titon\Route\GroupCallback $callback
      * @return $this
@@ -385,6 +852,42 @@ class Router implements Subject {
         return $this->cached;
     }
 
+    /**
+     * Load the route table from a class generated by `Titon\Route\Generator\RouteTableGenerator`.
+     * Previously mapped routes are replaced, and the storage engine is skipped entirely,
+     * as the table is already compiled and kept in the bytecode cache.
+     *
+     * The table is rejected if it no longer matches its fingerprint, like when the cache format, a constraint,
+     * or the case policy changed since it was generated, or if routes were mapped that the table was not generated from.
+     *
+     * @param \Titon\Route\Generator\GeneratedTable $table
+     * @return $this
+     * @throws \Titon\Route\Exception\StaleMatcherException
+     */
+    public function loadTable(GeneratedTable $table): this {
+        $routes = $this->getSerializer()->hydrate($table->getTable());
+        $fingerprint = $table->getFingerprint();
+
+        foreach ($routes as $route) {
+            $route->setCasePolicy($this->getCasePolicy());
+        }
+
+        if ($this->hashRoutes($routes) !== $fingerprint || ($this->routes && $this->getFingerprint() !== $fingerprint)) {
+            throw new StaleMatcherException(sprintf('Generated table %s does not match the mapped routes and must be regenerated', get_class($table)));
+        }
+
+        $this->routes = $routes;
+        $this->shardIndex->clear();
+        $this->pendingShards->clear();
+        $this->methodRoutes->clear();
+
+        $this->matchCache?->flush();
+        $this->missCache?->flush();
+        $this->cached = true;
+
+        return $this;
+    }
+
     /**
      * Add a custom defined route object that matches to an internal destination.
      *
@@ -393,12 +896,41 @@ class Router implements Subject {
      * @return \Titon\Route\Route
      */
     public function map(string $key, Route $route): Route {
+        $route->setCasePolicy($this->getCasePolicy());
+
+        // Routes mapped after the table was loaded from the cache are kept in place of cached routes
+        if ($this->shardIndex->contains($key)) {
+            $this->shardIndex->remove($key);
+            $this->cachedRoutes->remove($key);
+        }
+
+        // Keep the key while shards are pending, so that the remaining shards can still be loaded
+        if (!$this->pendingShards) {
+            $this->cacheKey = '';
+        }
+
         $this->routes[$key] = $route;
+        $this->methodRoutes->clear();
+        $this->cachedFingerprint = '';
+
+        // Replacing a route does not change the size of the route map, so flush built indexes explicitly
+        $matcher = $this->getMatcher();
+
+        if ($matcher instanceof AbstractIndexMatcher) {
+            $matcher->flush();
+        }
+
+        $this->matchCache?->flush();
+        $this->missCache?->flush();
 
         // Apply group options
         foreach ($this->getGroups() as $group) {
             $route->setSecure($group->getSecure());
 
+            if ($host = $group->getHost()) {
+                $route->setHost($host);
+            }
+
             if ($prefix = $group->getPrefix()) {
                 $route->prepend($prefix);
             }
@@ -411,6 +943,10 @@ class Router implements Subject {
                 $route->addPatterns($patterns);
             }
 
+            if ($constraints = $group->getConstraints()) {
+                $route->addConstraints($constraints);
+            }
+
             if ($filters = $group->getFilters()) {
                 $route->addFilters($filters);
             }
@@ -422,32 +958,79 @@ class Router implements Subject {
             if ($conditions = $group->getConditions()) {
                 $route->addConditions($conditions);
             }
+
+            if ($conditions = $group->getAsyncConditions()) {
+                $route->addAsyncConditions($conditions);
+            }
+
+            if ($rules = $group->getRules()) {
+                $route->addRules($rules);
+            }
         }
 
         return $route;
     }
 
     /**
-     * Attempt to match an internal route.
+     * Attempt to match an internal route, and return the result of the match.
+     * If no request context is defined, one will be created from the current request.
      *
      * @param string $url
-     * @return \Titon\Route\Route
+     * @param \Titon\Route\RequestContext $context
+     * @return \Titon\Route\MatchResult
      * @throws \Titon\Route\Exception\NoMatchException
      */
-    public function match(string $url): Route {
+    public function match(string $url, ?RequestContext $context = null): MatchResult {
         $this->emit(new MatchingEvent($this, $url));
 
-        $match = $this->getMatcher()->match($url, $this->getRoutes());
+        $url = $this->normalizeUrl($url);
+        $context = $context ?: RequestContext::createFromGlobals();
+        $routes = $this->getRoutesByContext($context);
 
-        if (!$match) {
-            throw new NoMatchException(sprintf('No route has been matched for %s', $url));
+        if ($match = $this->loadMatch($url, $context, $routes)) {
+            return $this->finishMatch($url, $context, $match);
         }
 
-        $this->current = $match;
+        $match = $this->getMatcher()->match($url, $routes, $context);
 
-        $this->emit(new MatchedEvent($this, $match));
+        return $this->finishMatch($url, $context, $this->saveMatch($url, $context, $match));
+    }
 
-        return $match;
+    /**
+     * Attempt to match a batch of URLs against the same request context, and return a map of results keyed by URL.
+     * URLs that do not match will have a null result. Routes are loaded and partitioned once for the whole batch,
+     * duplicate URLs are only matched once, and no events are emitted, nor exceptions thrown, per URL.
+     *
+     * @param Traversable<string> $urls
+     * @param \Titon\Route\RequestContext $context
+     * @return Map<string, ?\Titon\Route\MatchResult>
+     */
+    public function matchMany(Traversable<string> $urls, ?RequestContext $context = null): Map<string, ?MatchResult> {
+        $urls = new Vector($urls);
+
+        // Load the index once for the whole batch, and then only the distinct shards the URLs can match
+        if ($this->loadIndex()) {
+            $shards = Set {RouteSerializer::WILDCARD_SHARD};
+
+            foreach ($urls as $url) {
+                $shards[] = RouteSerializer::getShard($url);
+            }
+
+            $this->loadShards($shards);
+        }
+
+        $context = $context ?: RequestContext::createFromGlobals();
+        $routes = $this->getRoutesByContext($context);
+        $matcher = $this->getMatcher();
+        $results = Map {};
+
+        foreach ($urls as $url) {
+            if (!$results->contains($url)) {
+                $results[$url] = $matcher->match($this->normalizeUrl($url), $routes, $context);
+            }
+        }
+
+        return $results;
     }
 
     /**
@@ -574,8 +1157,11 @@ class Router implements Subject {
 
             $newRoute->setStatic($route->getStatic());
             $newRoute->setSecure($route->getSecure());
+            $newRoute->setHost($route->getHost());
             $newRoute->setFilters($route->getFilters());
             $newRoute->setPatterns($route->getPatterns());
+            $newRoute->setConstraints($route->getConstraints());
+            $newRoute->setRules($route->getRules());
             $newRoute->setMethods($methods);
 
             $this->map($key . '.' . $resource, $newRoute);
@@ -585,13 +1171,76 @@ class Router implements Subject {
     }
 
     /**
-     * Set the matcher.
+     * Set the amount of seconds a process holds the lease to build and cache the route table.
+     * Should be longer than it takes to compile and save the table, as the lease is never released early.
+     *
+     * @param int $seconds
+     * @return $this
+     */
+    public function setCacheLease(int $seconds): this {
+        $this->cacheLease = max(1, $seconds);
+
+        return $this;
+    }
+
+    /**
+     * Set how the casing of a URL is treated when matching, and apply it to all mapped routes.
+     * Insensitive matches with case-insensitive regex, sensitive matches bytes exactly,
+     * while normalize lowercases the URL once before matching, so that routes can compare bytes exactly.
+     *
+     * @param string $policy
+     * @return $this
+     */
+    public function setCasePolicy(string $policy): this {
+        foreach ($this->getRoutes() as $route) {
+            $route->setCasePolicy($policy);
+        }
+
+        $this->casePolicy = $policy;
+        $this->methodRoutes->clear();
+        $this->cacheKey = '';
+        $this->matchCache?->flush();
+        $this->missCache?->flush();
+
+        return $this;
+    }
+
+    /**
+     * Set the match cache. Repeated requests for the same method, scheme, host, and URL
+     * will be resolved from the cache instead of the matcher.
+     *
+     * @param \Titon\Route\MatchCache $cache
+     * @return $this
+     */
+    public function setMatchCache(MatchCache $cache): this {
+        $this->matchCache = $cache;
+
+        return $this;
+    }
+
+    /**
+     * Set the miss cache. Repeated requests for the same method, scheme, host, and URL that
+     * previously failed to match will be rejected without running the matcher.
+     *
+     * @param \Titon\Route\MissCache $cache
+     * @return $this
+     */
+    public function setMissCache(MissCache $cache): this {
+        $this->missCache = $cache;
+
+        return $this;
+    }
+
+    /**
+     * Set the matcher. The partitions are cleared so that the matcher is prepared,
+     * and validated against the mapped routes, before the next match.
      *
      * @param \Titon\Route\Matcher $matcher
      * @return $this
      */
     public function setMatcher(Matcher $matcher): this {
         $this->matcher = $matcher;
+        $this->methodRoutes->clear();
 
         return $this;
     }
@@ -608,6 +1257,18 @@ class Router implements Subject {
         return $this;
     }
 
+    /**
+     * Set the route table serializer.
+     *
+     * @param \Titon\Route\RouteSerializer $serializer
+     * @return $this
+     */
+    public function setSerializer(RouteSerializer $serializer): this {
+        $this->serializer = $serializer;
+
+        return $this;
+    }
+
     /**
      * Set the storage engine.
      *
@@ -649,4 +1310,422 @@ class Router implements Subject {
         return $this;
     }
 
+    /**
+     * Attempt to acquire the lease to build and cache the route table, so that processes that miss the cache
+     * at the same time, like after a deploy, do not all compile and save the same table. Will return false if
+     * another process holds the lease, or if the table has been cached since it was last checked.
+     *
+     * The storage engine has no atomic add, so the lease is written and then read back, and only the last
+     * writer wins. Processes racing within that window may still both build the table, but the result is identical.
+     *
+     * @param \Titon\Cache\Storage $storage
+     * @return bool
+     */
+    protected function acquireCacheLease(Storage $storage): bool {
+        $key = $this->getCacheKey() . '.lease';
+
+        if ($storage->getItem($key)->isHit() || $storage->getItem($this->getCacheKey())->isHit()) {
+            return false;
+        }
+
+        $token = uniqid((string) getmypid(), true);
+
+        $storage->save(new Item($key, $token, sprintf('+%s seconds', $this->getCacheLease())));
+
+        return ($storage->getItem($key)->get() === $token);
+    }
+
+    /**
+     * Store a match result in the match cache. Results are only cached if neither the matched route,
+     * nor any route mapped before it, has conditions, and no route mapped before it has rules,
+     * as both may depend on more than the cache key. The routes must be the host partition,
+     * as the context partition no longer contains the routes whose rules failed.
+     *
+     * @param \Titon\Route\MatchCache $cache
+     * @param string $cacheKey
+     * @param \Titon\Route\RouteMap $routes
+     * @param \Titon\Route\MatchResult $match
+     * @return $this
+     */
+    protected function cacheMatch(MatchCache $cache, string $cacheKey, RouteMap $routes, MatchResult $match): this {
+        foreach ($routes as $key => $route) {
+            if ($route->hasConditions()) {
+                return $this;
+            }
+
+            if ($key === $match->getKey()) {
+                $cache->set($cacheKey, $match);
+                break;
+            }
+
+            if ($route->getRules()) {
+                return $this;
+            }
+        }
+
+        return $this;
+    }
+
+    /**
+     * Store a failed match in the miss cache. Misses are only cached if no candidate route has conditions or rules,
+     * as both may depend on more than the cache key. The routes must be the host partition,
+     * as the context partition no longer contains the routes whose rules failed.
+     *
+     * @param \Titon\Route\MissCache $cache
+     * @param string $cacheKey
+     * @param \Titon\Route\RouteMap $routes
+     * @return $this
+     */
+    protected function cacheMiss(MissCache $cache, string $cacheKey, RouteMap $routes): this {
+        foreach ($routes as $route) {
+            if ($route->hasConditions() || $route->getRules()) {
+                return $this;
+            }
+        }
+
+        $cache->add($cacheKey);
+
+        return $this;
+    }
+
+    /**
+     * Complete a match by throwing an exception if no route matched,
+     * or by setting the current route and emitting the matched event.
+     *
+     * @param string $url
+     * @param \Titon\Route\RequestContext $context
+     * @param \Titon\Route\MatchResult $match
+     * @return \Titon\Route\MatchResult
+     * @throws \Titon\Route\Exception\NoMatchException
+     */
+    protected function finishMatch(string $url, RequestContext $context, ?MatchResult $match): MatchResult {
+        $this->context = $context;
+
+        if (!$match) {
+            throw new NoMatchException(sprintf('No route has been matched for %s', $url));
+        }
+
+        $this->current = $match;
+
+        $this->emit(new MatchedEvent($this, $match));
+
+        return $match;
+    }
+
+    /**
+     * Return the key of the host partition for an HTTP method and host name, which is derived from the host patterns
+     * that match the host name. Each distinct host pattern is evaluated once per host name. Host names are client
+     * provided, so the keys are kept bounded, but only keys are cached per host name, not route maps or indexes.
+     *
+     * @param string $method
+     * @param string $host
+     * @return string
+     */
+    protected function getHostKey(string $method, string $host): string {
+        $method = strtolower($method);
+        $cacheKey = $method . '|' . $host;
+
+        if (($cached = $this->hostKeys->get($cacheKey)) !== null) {
+            return $cached;
+        }
+
+        $hosts = Map {};
+
+        foreach ($this->getRoutesByMethod($method) as $route) {
+            $pattern = $route->getHost();
+
+            if ($pattern !== '' && !$hosts->contains($pattern)) {
+                $hosts[$pattern] = $this->matchesHost($route, $host);
+            }
+        }
+
+        $matched = $hosts->filter($matches ==> $matches)->keys()->toArray();
+        sort($matched);
+
+        $hostKey = $method . '|' . md5(implode("\n", $matched));
+
+        $this->hostKeys->set($cacheKey, $hostKey);
+
+        return $hostKey;
+    }
+
+    /**
+     * Load the index of the cached route table from the storage engine if it has not been loaded already.
+     * Return true if the route table is cached, in which case its shards can be loaded.
+     *
+     * @return bool
+     */
+    protected function loadIndex(): bool {
+        if (!$this->isCached()) {
+            $item = $this->getStorage()?->getItem($this->getCacheKey());
+
+            if ($item === null || !$item->isHit()) {
+                return false;
+            }
+
+            // Payloads from an older format are ignored, and replaced once the mapped routes are cached again
+            $index = $this->getSerializer()->decodeIndex((string) $item->get());
+
+            if ($index === null) {
+                return false;
+            }
+
+            $this->mappedRoutes = $this->routes;
+            $this->routes = Map {};
+            $this->cachedRoutes = Map {};
+            $this->cachedFingerprint = $index['fingerprint'];
+            $this->shardIndex = $index['shards'];
+            $this->pendingShards = $index['shards']->values()->toSet();
+            $this->methodRoutes->clear();
+            $this->matchCache?->flush();
+            $this->missCache?->flush();
+            $this->cached = true;
+        }
+
+        return true;
+    }
+
+    /**
+     * Return a previous match result from the match cache, or null if none exists.
+     * Will throw an exception if the URL is a known miss.
+     *
+     * @param string $url
+     * @param \Titon\Route\RequestContext $context
+     * @param \Titon\Route\RouteMap $routes
+     * @return \Titon\Route\MatchResult
+     * @throws \Titon\Route\Exception\NoMatchException
+     */
+    protected function loadMatch(string $url, RequestContext $context, RouteMap $routes): ?MatchResult {
+        $misses = $this->getMissCache();
+
+        if ($misses && $misses->has(MissCache::key($context, $url, $this->getCasePolicy() === self::CASE_INSENSITIVE))) {
+            throw new NoMatchException(sprintf('No route has been matched for %s', $url));
+        }
+
+        $cache = $this->getMatchCache();
+
+        if ($cache && ($cached = $cache->get(MatchCache::key($context, $url))) && $routes->contains($cached->getKey())) {
+            return $cached;
+        }
+
+        return null;
+    }
+
+    /**
+     * Load the index of the cached route table from the storage engine if it has not been loaded already,
+     * and then load the shards that can match the URL. If no URL is defined, all shards are loaded.
+     *
+     * @param string $url
+     * @return $this
+     */
+    protected function loadRoutes(?string $url = null): this {
+        if (!$this->loadIndex()) {
+            return $this;
+        }
+
+        if ($url === null) {
+            return $this->loadShards($this->pendingShards->toArray());
+        }
+
+        return $this->loadShards([RouteSerializer::getShard($url), RouteSerializer::WILDCARD_SHARD]);
+    }
+
+    /**
+     * Load a shard of the cached route table from the storage engine.
+     * If the shard has been evicted, can not be decoded, or references an unregistered callback or condition,
+     * the mapped routes of the shard are used instead.
+     *
+     * @param string $shard
+     * @return \Titon\Route\RouteMap
+     */
+    protected function loadShard(string $shard): RouteMap {
+        $item = $this->getStorage()?->getItem($this->getCacheKey($shard));
+        $routes = null;
+
+        // Callbacks and conditions may have been renamed, or not registered yet, so fall back to the mapped routes
+        try {
+            if ($item !== null && $item->isHit()) {
+                $routes = $this->getSerializer()->decode((string) $item->get());
+            }
+        } catch (MissingCallbackException $e) {
+            $routes = null;
+        }
+
+        if ($routes) {
+            foreach ($routes as $route) {
+                $route->setCasePolicy($this->getCasePolicy());
+            }
+
+            // Routes that could not be cached are used from the mapped routes
+            foreach ($this->shardIndex as $key => $routeShard) {
+                if ($routeShard === $shard && !$routes->contains($key) && $this->mappedRoutes->contains($key)) {
+                    $routes[$key] = $this->mappedRoutes[$key];
+                }
+            }
+
+            return $routes;
+        }
+
+        return $this->mappedRoutes->filterWithKey(($key, $route) ==> ($this->shardIndex->get($key) === $shard));
+    }
+
+    /**
+     * Load the defined shards of the cached route table, if they have not been loaded already,
+     * and rebuild the route table from all loaded shards in the order routes were mapped.
+     *
+     * @param Traversable<string> $shards
+     * @return $this
+     */
+    protected function loadShards(Traversable<string> $shards): this {
+        $loaded = false;
+
+        foreach ($shards as $shard) {
+            if (!$this->pendingShards->contains($shard)) {
+                continue;
+            }
+
+            $this->pendingShards->remove($shard);
+            $this->cachedRoutes->setAll($this->loadShard($shard));
+
+            $loaded = true;
+        }
+
+        if (!$loaded) {
+            return $this;
+        }
+
+        $routes = Map {};
+
+        foreach ($this->shardIndex as $key => $shard) {
+            if ($this->cachedRoutes->contains($key)) {
+                $routes[$key] = $this->cachedRoutes[$key];
+            }
+        }
+
+        // Routes mapped after the table was loaded are kept, after the cached routes
+        foreach ($this->routes as $key => $route) {
+            if (!$this->shardIndex->contains($key)) {
+                $routes[$key] = $route;
+            }
+        }
+
+        $this->routes = $routes;
+        $this->methodRoutes->clear();
+
+        return $this;
+    }
+
+    /**
+     * Hash the definition of all mapped routes that affect matching and dispatching, along with the version
+     * of the cache format, as it changes whenever compiled output changes. Compiling a route does not modify
+     * its definition, so the hash is the same for mapped routes and for routes loaded from the cache.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @return string
+     */
+    protected function hashRoutes(RouteMap $routes): string {
+        $fingerprint = [];
+
+        foreach ($routes as $key => $route) {
+            // Sort methods as their order does not affect matching, and is not retained by the route cache
+            $methods = $route->getMethods()->toArray();
+            sort($methods);
+
+            $fingerprint[] = implode('|', [
+                $key,
+                get_class($route),
+                static::buildAction($route->getAction()),
+                ($route instanceof CallbackRoute) ? (string) CallbackRegistry::getName($route->getCallback()) : '',
+                $route->getHost(),
+                $route->getPath(),
+                implode(',', $methods),
+                implode(',', $route->getFilters()),
+                http_build_query($route->getPatterns()->toArray()),
+                // Hash the resolved patterns, as a registered constraint can change without the route changing
+                http_build_query($route->getConstraints()->map($name ==> Constraint::has($name) ? Constraint::getPattern($name) : '')->toArray()),
+                $route->getSecure() ? 'secure' : '',
+                $route->getStatic() ? 'static' : '',
+                $route->getCasePolicy(),
+                implode(',', $route->getConditions()->map($condition ==> (string) CallbackRegistry::getName($condition))),
+                implode(',', $route->getAsyncConditions()->map($condition ==> (string) CallbackRegistry::getName($condition))),
+                implode(',', $route->getRules()->map($rule ==> $rule->getKey()))
+            ]);
+        }
+
+        $fingerprint[] = RouteSerializer::VERSION;
+
+        return md5(implode("\n", $fingerprint));
+    }
+
+    /**
+     * Return true if the host pattern of a route matches the host name. Host patterns without tokens
+     * are compared by name, case-insensitively, instead of evaluating a regex.
+     *
+     * @param \Titon\Route\Route $route
+     * @param string $host
+     * @return bool
+     */
+    protected function matchesHost(Route $route, string $host): bool {
+        $pattern = $route->getHost();
+
+        if (strpbrk($pattern, '{<') === false) {
+            return (strcasecmp($pattern, $host) === 0);
+        }
+
+        return (bool) preg_match($route->getHostRegex(), $host);
+    }
+
+    /**
+     * Lowercase the URL if the case policy requires normalization.
+     *
+     * @param string $url
+     * @return string
+     */
+    protected function normalizeUrl(string $url): string {
+        return ($this->getCasePolicy() === self::CASE_NORMALIZE) ? strtolower($url) : $url;
+    }
+
+    /**
+     * Prepare the matcher for a newly built route table.
+     * Flushes indexes built from the previous table, and validates generated matchers against the current table.
+     *
+     * @return $this
+     * @throws \Titon\Route\Exception\StaleMatcherException
+     */
+    protected function prepareMatcher(): this {
+        $matcher = $this->getMatcher();
+
+        if ($matcher instanceof AbstractIndexMatcher) {
+            $matcher->flush();
+
+        } else if ($matcher instanceof GeneratedMatcher && $matcher->getFingerprint() !== $this->getFingerprint()) {
+            throw new StaleMatcherException(sprintf('Generated matcher %s does not match the mapped routes and must be regenerated', get_class($matcher)));
+        }
+
+        return $this;
+    }
+
+    /**
+     * Store the result of a matcher in the match cache, or store the URL in the miss cache if no route matched.
+     *
+     * @param string $url
+     * @param \Titon\Route\RequestContext $context
+     * @param \Titon\Route\MatchResult $match
+     * @return \Titon\Route\MatchResult
+     */
+    protected function saveMatch(string $url, RequestContext $context, ?MatchResult $match): ?MatchResult {
+        $routes = $this->getRoutesByHost($context->getMethod(), $context->getHost());
+
+        if ($match) {
+            if ($cache = $this->getMatchCache()) {
+                $this->cacheMatch($cache, MatchCache::key($context, $url), $routes, $match);
+            }
+
+        } else if ($misses = $this->getMissCache()) {
+            $this->cacheMiss($misses, MissCache::key($context, $url, $this->getCasePolicy() === self::CASE_INSENSITIVE), $routes);
+        }
+
+        return $match;
+    }
+
 }
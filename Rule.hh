@@ -0,0 +1,182 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+/**
+ * A Rule is a declarative condition that is evaluated against the request context.
+ * Unlike condition callbacks, rules are plain values, so they can be serialized into the route cache,
+ * and are identified by their key, so that each distinct rule is evaluated once per request
+ * and routes can be bucketed by the rules they fail.
+ *
+ * @package Titon\Route
+ */
+class Rule {
+
+    /**
+     * Rule types.
+     */
+    const string CONTENT_TYPE = 'contentType';
+    const string HEADER = 'header';
+    const string HEADER_REGEX = 'headerRegex';
+    const string HOST = 'host';
+    const string QUERY = 'query';
+
+    /**
+     * The header, query param, or host name to evaluate.
+     *
+     * @var string
+     */
+    protected string $name;
+
+    /**
+     * The type of rule.
+     *
+     * @var string
+     */
+    protected string $type;
+
+    /**
+     * The value or regex to compare against.
+     *
+     * @var string
+     */
+    protected string $value;
+
+    /**
+     * Store the rule settings.
+     *
+     * @param string $type
+     * @param string $name
+     * @param string $value
+     */
+    public function __construct(string $type, string $name, string $value = '') {
+        $this->type = $type;
+        $this->name = $name;
+        $this->value = $value;
+    }
+
+    /**
+     * Create a rule that requires the media type of the request body, ignoring any parameters like the charset.
+     *
+     * @param string $type
+     * @return \Titon\Route\Rule
+     */
+    public static function contentType(string $type): Rule {
+        return new Rule(self::CONTENT_TYPE, 'content-type', strtolower($type));
+    }
+
+    /**
+     * Evaluate the rule against a request context.
+     *
+     * @param \Titon\Route\RequestContext $context
+     * @return bool
+     */
+    public function evaluate(RequestContext $context): bool {
+        switch ($this->getType()) {
+            case self::CONTENT_TYPE:
+                $header = (string) $context->getHeader($this->getName());
+
+                return (strtolower(trim(explode(';', $header)[0])) === $this->getValue());
+
+            case self::HEADER:
+                return ($context->getHeader($this->getName()) === $this->getValue());
+
+            case self::HEADER_REGEX:
+                $header = $context->getHeader($this->getName());
+
+                return ($header !== null && (bool) preg_match($this->getValue(), $header));
+
+            case self::HOST:
+                return ($context->getHost() === $this->getName());
+
+            case self::QUERY:
+                return $context->hasQuery($this->getName());
+        }
+
+        return false;
+    }
+
+    /**
+     * Return the key that uniquely identifies the rule.
+     *
+     * @return string
+     */
+    public function getKey(): string {
+        return implode('|', [$this->getType(), $this->getName(), $this->getValue()]);
+    }
+
+    /**
+     * Return the name.
+     *
+     * @return string
+     */
+    public function getName(): string {
+        return $this->name;
+    }
+
+    /**
+     * Return the type.
+     *
+     * @return string
+     */
+    public function getType(): string {
+        return $this->type;
+    }
+
+    /**
+     * Return the value.
+     *
+     * @return string
+     */
+    public function getValue(): string {
+        return $this->value;
+    }
+
+    /**
+     * Create a rule that requires a header to equal a value.
+     *
+     * @param string $name
+     * @param string $value
+     * @return \Titon\Route\Rule
+     */
+    public static function header(string $name, string $value): Rule {
+        return new Rule(self::HEADER, RequestContext::normalizeHeader($name), $value);
+    }
+
+    /**
+     * Create a rule that requires a header to match a regex pattern.
+     *
+     * @param string $name
+     * @param string $regex
+     * @return \Titon\Route\Rule
+     */
+    public static function headerMatches(string $name, string $regex): Rule {
+        return new Rule(self::HEADER_REGEX, RequestContext::normalizeHeader($name), $regex);
+    }
+
+    /**
+     * Create a rule that requires the request to be made to an exact host name.
+     *
+     * @param string $host
+     * @return \Titon\Route\Rule
+     */
+    public static function host(string $host): Rule {
+        return new Rule(self::HOST, strtolower($host));
+    }
+
+    /**
+     * Create a rule that requires a query param to be present.
+     *
+     * @param string $name
+     * @return \Titon\Route\Rule
+     */
+    public static function query(string $name): Rule {
+        return new Rule(self::QUERY, $name);
+    }
+
+}
@@ -81,19 +81,22 @@ class UrlBuilder {
     public function build(string $key, ParamMap $params = Map {}, QueryMap $query = Map {}): string {
         $base = $this->getBase();
         $route = $this->getRouter()->getRoute($key);
-        $url = str_replace([']', ')', '>'], '}', str_replace(['[', '(', '<'], '{', $route->getPath()));
+        $url = '';
 
         // Set the locale if it is missing
         if (!$params->contains('locale')) {
             $params['locale'] = Config::get('titon.locale.current');
         }
 
-        // Replace tokens in the path with values from the parameters
-        foreach ($route->getTokens() as $token) {
-            $tokenKey = $token['token'];
+        // Join the literal parts of the path with values from the parameters
+        foreach ($route->getParts() as $part) {
+            $tokenKey = $part['value'];
 
-            if ($params->contains($tokenKey) || $token['optional']) {
-                $url = str_replace(sprintf('{%s}', $tokenKey . ($token['optional'] ? '?' : '')), Inflect::route((string) $params->get($tokenKey) ?: ''), $url);
+            if ($part['type'] === 'literal') {
+                $url .= $tokenKey;
+
+            } else if ($params->contains($tokenKey) || $part['optional']) {
+                $url .= Inflect::route((string) $params->get($tokenKey) ?: '');
 
             } else {
                 throw new MissingTokenException(sprintf('Missing %s parameter for the %s route', $tokenKey, $key));
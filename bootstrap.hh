@@ -18,28 +18,55 @@ namespace Titon\Route {
 
     type Action = shape('class' => string, 'action' => string);
     type ArgumentList = array<mixed>;
-    type FilterCallback = (function(Router, Route): void);
+    type ConstraintCallback = (function(string): bool);
+    type ConstraintDefinition = shape('pattern' => string, 'validator' => ConstraintCallback);
+    type FilterCallback = (function(Router, MatchResult): void);
     type FilterMap = Map<string, FilterCallback>;
     type GroupCallback = (function(Router, RouteGroup): void);
     type GroupList = Vector<RouteGroup>;
     type ParamMap = Map<string, mixed>;
+    type PathPart = shape('type' => string, 'value' => string, 'pattern' => string, 'optional' => bool);
+    type PathPartList = Vector<PathPart>;
+    type PathSegmentList = Vector<PathPartList>;
     type QueryMap = Map<string, mixed>;
     type ResourceMap = Map<string, string>;
     type RouteCallback = (function(...): mixed);
     type RouteMap = Map<string, Route>;
     type SegmentMap = Map<string, mixed>;
+    type ShardIndex = shape('fingerprint' => string, 'shards' => Map<string, string>);
     type Token = shape('token' => string, 'optional' => bool);
     type TokenList = Vector<Token>;
 }
 
 namespace Titon\Route\Mixin {
     use Titon\Route\Route;
+    use Titon\Route\Rule;
 
+    type AsyncConditionCallback = (function(Route): Awaitable<bool>);
+    type AsyncConditionList = Vector<AsyncConditionCallback>;
     type ConditionCallback = (function(Route): bool);
     type ConditionList = Vector<ConditionCallback>;
+    type ConstraintMap = Map<string, string>;
     type FilterList = Vector<string>;
     type MethodList = Vector<string>;
     type PatternMap = Map<string, string>;
+    type RuleList = Vector<Rule>;
+}
+
+namespace Titon\Route\Matcher {
+    use Titon\Route\Route;
+
+    type CombinedChunk = shape('keys' => Vector<string>, 'regex' => string, 'routes' => Vector<Route>);
+    type CombinedIndex = Vector<CombinedChunk>;
+    type LoopIndex = shape(
+        'dynamic' => Vector<int>,
+        'fold' => bool,
+        'keys' => Vector<string>,
+        'routes' => Vector<Route>,
+        'shadows' => Map<string, Set<int>>,
+        'static' => Map<string, Vector<int>>
+    );
+    type TrieIndex = shape('exact' => Map<string, Vector<bool>>, 'fold' => bool, 'keys' => Vector<string>, 'root' => TrieNode, 'routes' => Vector<Route>);
 }
 
 /**